@@ -0,0 +1,295 @@
+#include <asyncSaveWorker.hpp>
+#include <configManager.hpp>
+#include <utility>
+
+std::atomic<asyncSaveWorker*> asyncSaveWorker::_instance(nullptr);
+
+asyncSaveWorker& asyncSaveWorker::instance()
+{
+    // Function-local static: two tasks saving for the first time still get one worker
+    static asyncSaveWorker* worker = create();
+    return *worker;
+}
+
+asyncSaveWorker* asyncSaveWorker::create()
+{
+    // Lives for the rest of the program; the worker never exits
+    asyncSaveWorker* worker = new asyncSaveWorker();
+    _instance.store(worker, std::memory_order_release);
+    return worker;
+}
+
+asyncSaveWorker::asyncSaveWorker() :
+    _running(nullptr),
+    _completed(0),
+    _coalesced(0),
+    _rejected(0)
+{
+    _queue.reserve(ASYNC_SAVE_QUEUE_DEPTH);
+#if defined(ESP32)
+    _mutex = xSemaphoreCreateMutex();
+    _task = nullptr;
+    xTaskCreatePinnedToCore(taskEntry, "cfgSave", ASYNC_SAVE_TASK_STACK, this,
+                            ASYNC_SAVE_TASK_PRIORITY, &_task, ASYNC_SAVE_TASK_CORE);
+#elif defined(CONFIGMGR_NATIVE)
+    std::thread(&asyncSaveWorker::workerLoop, this).detach();
+#endif
+}
+
+bool asyncSaveWorker::submit(configManager* owner, const String& path, configSnapshot&& snapshot,
+                             std::set<String>&& dirtySections, asyncSaveCallback callback, void* context)
+{
+    saveJob job;
+    job.owner = owner;
+    job.path = path;
+    job.snapshot = std::move(snapshot);
+    job.dirtySections = std::move(dirtySections);
+    job.callback = callback;
+    job.context = context;
+    job.sharded = false;
+    job.writeManifest = false;
+    return enqueue(job);
+}
+
+bool asyncSaveWorker::submitShards(configManager* owner, configSnapshot&& shards, std::set<String>&& dirtySections,
+                                   bool writeManifest, const std::vector<String>& manifest,
+                                   asyncSaveCallback callback, void* context)
+{
+    saveJob job;
+    job.owner = owner;
+    job.snapshot = std::move(shards);
+    job.dirtySections = std::move(dirtySections);
+    job.callback = callback;
+    job.context = context;
+    job.sharded = true;
+    job.writeManifest = writeManifest;
+    job.manifest = manifest;
+    return enqueue(job);
+}
+
+bool asyncSaveWorker::enqueue(saveJob& job)
+{
+#if ASYNC_SAVE_THREADED
+    lock();
+    for (auto& queued : _queue)
+    {
+        if (queued.owner == job.owner)
+        {
+            // Write-behind coalescing: only the newest snapshot reaches the flash
+            configManager* owner = job.owner;
+            asyncSaveCallback superseded = queued.callback;
+            void* supersededContext = queued.context;
+            if (queued.sharded && job.sharded)
+            {
+                // Each job carries only its own dirty sections; keep the older ones too
+                for (auto& section : queued.snapshot)
+                {
+                    job.snapshot.insert(std::move(section));
+                }
+                job.writeManifest = job.writeManifest || queued.writeManifest;
+            }
+            // The replacement now answers for the older job's sections too
+            job.dirtySections.insert(queued.dirtySections.begin(), queued.dirtySections.end());
+            queued = std::move(job);
+            _coalesced++;
+            unlock();
+            if (superseded)
+            {
+                superseded(owner, ASYNC_SAVE_SUPERSEDED, supersededContext);
+            }
+            return true;
+        }
+    }
+
+    if (_queue.size() >= ASYNC_SAVE_QUEUE_DEPTH)
+    {
+        _rejected++;
+        unlock();
+        return false;
+    }
+
+    _queue.push_back(std::move(job));
+    unlock();
+
+#if defined(ESP32)
+    xTaskNotifyGive(_task);
+#else
+    _workAvailable.notify_one();
+#endif
+    return true;
+#else
+    run(job);
+    _completed++;
+    return true;
+#endif
+}
+
+bool asyncSaveWorker::isPending(const configManager* owner)
+{
+    asyncSaveWorker* worker = _instance.load(std::memory_order_acquire);
+    if (!worker)
+    {
+        return false;
+    }
+    worker->lock();
+    const bool pending = worker->hasJobFor(owner);
+    worker->unlock();
+    return pending;
+}
+
+bool asyncSaveWorker::wait(const configManager* owner, uint32_t timeoutMs)
+{
+    // Must not be called from a completion callback for the same config
+    const unsigned long start = millis();
+    while (isPending(owner))
+    {
+        if (timeoutMs != UINT32_MAX && (millis() - start) >= timeoutMs)
+        {
+            return false;
+        }
+        delay(1);
+    }
+    return true;
+}
+
+void asyncSaveWorker::cancel(const configManager* owner)
+{
+    asyncSaveWorker* worker = _instance.load(std::memory_order_acquire);
+    if (!worker)
+    {
+        return;
+    }
+
+    std::vector<saveJob> dropped;
+    worker->lock();
+    for (auto it = worker->_queue.begin(); it != worker->_queue.end();)
+    {
+        if (it->owner == owner)
+        {
+            dropped.push_back(std::move(*it));
+            it = worker->_queue.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    worker->unlock();
+
+    for (auto& job : dropped)
+    {
+        finish(job, ASYNC_SAVE_CANCELLED);
+    }
+    wait(owner, UINT32_MAX);
+}
+
+uint8_t asyncSaveWorker::getQueueDepth() const
+{
+    lock();
+    const uint8_t depth = static_cast<uint8_t>(_queue.size());
+    unlock();
+    return depth;
+}
+
+bool asyncSaveWorker::hasJobFor(const configManager* owner) const
+{
+    if (_running == owner)
+    {
+        return true;
+    }
+    for (const auto& queued : _queue)
+    {
+        if (queued.owner == owner)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void asyncSaveWorker::run(saveJob& job)
+{
+    const bool ok = job.sharded
+        ? job.owner->saveShards(job.snapshot, job.writeManifest ? &job.manifest : nullptr)
+        : job.owner->saveToJson(job.path, job.snapshot);
+    finish(job, ok ? ASYNC_SAVE_OK : ASYNC_SAVE_FAILED);
+}
+
+void asyncSaveWorker::finish(saveJob& job, asyncSaveResult result)
+{
+    // Bookkeeping first, so the callback already sees the outcome
+    job.owner->finishAsyncSave(result == ASYNC_SAVE_OK, job.dirtySections, job.sharded ? &job.manifest : nullptr);
+    if (job.callback)
+    {
+        job.callback(job.owner, result, job.context);
+    }
+}
+
+void asyncSaveWorker::lock() const
+{
+#if defined(ESP32)
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.lock();
+#endif
+}
+
+void asyncSaveWorker::unlock() const
+{
+#if defined(ESP32)
+    xSemaphoreGive(_mutex);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.unlock();
+#endif
+}
+
+#if ASYNC_SAVE_THREADED
+void asyncSaveWorker::workerLoop()
+{
+    for (;;)
+    {
+        saveJob job;
+        takeJob(job);
+        run(job);
+
+        lock();
+        _running = nullptr;
+        _completed++;
+        unlock();
+    }
+}
+
+void asyncSaveWorker::takeJob(saveJob& job)
+{
+#if defined(ESP32)
+    for (;;)
+    {
+        lock();
+        if (!_queue.empty())
+        {
+            job = std::move(_queue.front());
+            _queue.erase(_queue.begin());
+            _running = job.owner;
+            unlock();
+            return;
+        }
+        unlock();
+        // A notify given between unlock() and here is kept, so no wakeup is lost
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+#else
+    std::unique_lock<std::mutex> guard(_mutex);
+    _workAvailable.wait(guard, [this] { return !_queue.empty(); });
+    job = std::move(_queue.front());
+    _queue.erase(_queue.begin());
+    _running = job.owner;
+#endif
+}
+#endif
+
+#if defined(ESP32)
+void asyncSaveWorker::taskEntry(void* arg)
+{
+    static_cast<asyncSaveWorker*>(arg)->workerLoop();
+}
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <map>
+#include <set>
+#include <vector>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#define ASYNC_SAVE_THREADED 1
+#ifndef ASYNC_SAVE_TASK_CORE
+#define ASYNC_SAVE_TASK_CORE tskNO_AFFINITY
+#endif
+#elif defined(CONFIGMGR_NATIVE)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#define ASYNC_SAVE_THREADED 1
+#else
+// No background task support (e.g. ESP8266): jobs run synchronously on submit
+#define ASYNC_SAVE_THREADED 0
+#endif
+
+class configManager;
+
+const uint8_t ASYNC_SAVE_QUEUE_DEPTH = 4;        // Pending jobs across all configManager instances
+const uint32_t ASYNC_SAVE_TASK_STACK = 8192;     // ESP32 worker stack (JSON serialization + file write)
+const uint8_t ASYNC_SAVE_TASK_PRIORITY = 1;      // Just above idle: flash work yields to the control loop
+
+/**
+ * @brief Result passed to an async save completion callback.
+ */
+enum asyncSaveResult : uint8_t {
+    ASYNC_SAVE_OK = 0,
+    ASYNC_SAVE_FAILED,
+    ASYNC_SAVE_SUPERSEDED,  // A newer snapshot of the same config replaced this one before it was written
+    ASYNC_SAVE_CANCELLED    // The owning configManager was destroyed before the job ran
+};
+
+typedef void (*asyncSaveCallback)(configManager* config, asyncSaveResult result, void* context);
+
+/**
+ * @brief Single background worker that persists configManager snapshots.
+ *
+ * configManager::saveConfigAsync() copies the in-memory config and queues it
+ * here; the worker (a FreeRTOS task on ESP32, a std::thread on native)
+ * serializes and writes it, updates the flash wear counter and then invokes
+ * the completion callback from the worker context.
+ *
+ * Back-pressure: at most ASYNC_SAVE_QUEUE_DEPTH jobs are pending. A new
+ * snapshot for a config that already has a queued (not yet started) job
+ * replaces that job, so a burst of saves costs one flash write. When the
+ * queue is full submit() fails and the caller decides whether to retry or
+ * save synchronously.
+ *
+ * Platforms without a threading layer run each job inline in submit().
+ */
+class asyncSaveWorker
+{
+public:
+    typedef std::map<String, std::map<String, String>> configSnapshot;
+
+    static asyncSaveWorker& instance();
+
+    // dirtySections: taken from the owner at submit, handed back unless the job is written
+    bool submit(configManager* owner, const String& path, configSnapshot&& snapshot,
+                std::set<String>&& dirtySections, asyncSaveCallback callback, void* context);
+
+    // Sharded layout: only the changed sections, plus the section list when the manifest must be rewritten
+    bool submitShards(configManager* owner, configSnapshot&& shards, std::set<String>&& dirtySections,
+                      bool writeManifest, const std::vector<String>& manifest,
+                      asyncSaveCallback callback, void* context);
+
+    // Safe to call before the worker exists; they never start it
+    static bool isPending(const configManager* owner);
+    static bool wait(const configManager* owner, uint32_t timeoutMs);
+
+    // Drops queued jobs of a config that is going away and waits for a running one
+    static void cancel(const configManager* owner);
+
+    // Statistics
+    uint32_t getCompleted() const { return _completed; }
+    uint32_t getCoalesced() const { return _coalesced; }
+    uint32_t getRejected() const { return _rejected; }
+    uint8_t getQueueDepth() const;
+
+private:
+    struct saveJob {
+        configManager* owner;
+        String path;
+        configSnapshot snapshot;
+        asyncSaveCallback callback;
+        void* context;
+        bool sharded;                  // snapshot holds only dirty sections
+        bool writeManifest;
+        std::vector<String> manifest;
+        std::set<String> dirtySections;
+    };
+
+    asyncSaveWorker();
+    static asyncSaveWorker* create();
+    bool enqueue(saveJob& job);
+    bool hasJobFor(const configManager* owner) const;
+    void run(saveJob& job);
+    static void finish(saveJob& job, asyncSaveResult result);
+    void lock() const;
+    void unlock() const;
+
+#if ASYNC_SAVE_THREADED
+    void workerLoop();
+    void takeJob(saveJob& job);
+#endif
+#if defined(ESP32)
+    static void taskEntry(void* arg);
+    TaskHandle_t _task;
+    SemaphoreHandle_t _mutex;
+#elif defined(CONFIGMGR_NATIVE)
+    mutable std::mutex _mutex;
+    std::condition_variable _workAvailable;
+#endif
+
+    static std::atomic<asyncSaveWorker*> _instance;  // Set once by create(); read by the static queries
+
+    std::vector<saveJob> _queue;
+    const configManager* _running;
+    uint32_t _completed;
+    uint32_t _coalesced;
+    uint32_t _rejected;
+};
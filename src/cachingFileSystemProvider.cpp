@@ -0,0 +1,251 @@
+#include <cachingFileSystemProvider.hpp>
+
+cachingFileSystemProvider::cachingFileSystemProvider(iFileSystemProvider* inner, size_t maxBytes, uint8_t maxEntries) :
+    _inner(inner),
+    _maxBytes(maxBytes),
+    _maxEntries(maxEntries),
+    _cachedBytes(0),
+    _useCounter(0),
+    _hits(0),
+    _misses(0),
+    _innerMounted(false)
+{
+#if defined(ESP32)
+    _mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+}
+
+cachingFileSystemProvider::~cachingFileSystemProvider()
+{
+#if defined(ESP32)
+    vSemaphoreDelete(_mutex);
+#endif
+}
+
+cachingFileSystemProvider::scopedLock::scopedLock(const cachingFileSystemProvider* cache) : _cache(cache)
+{
+#if defined(ESP32)
+    xSemaphoreTakeRecursive(_cache->_mutex, portMAX_DELAY);
+#elif defined(CONFIGMGR_NATIVE)
+    _cache->_mutex.lock();
+#endif
+}
+
+cachingFileSystemProvider::scopedLock::~scopedLock()
+{
+#if defined(ESP32)
+    xSemaphoreGiveRecursive(_cache->_mutex);
+#elif defined(CONFIGMGR_NATIVE)
+    _cache->_mutex.unlock();
+#endif
+}
+
+bool cachingFileSystemProvider::begin()
+{
+    // Deferred until ensureMounted(); a cache hit never touches the flash
+    return _inner != nullptr;
+}
+
+bool cachingFileSystemProvider::end()
+{
+    scopedLock guard(this);
+    if (_innerMounted)
+    {
+        _innerMounted = false;
+        return _inner->end();
+    }
+    return true;
+}
+
+fs::File cachingFileSystemProvider::open(const char *path, const char *mode)
+{
+    scopedLock guard(this);
+    if (!ensureMounted())
+    {
+        return fs::File();
+    }
+    if (mode && (mode[0] == 'w' || mode[0] == 'a' || (mode[0] && mode[1] == '+')))
+    {
+        // Content will change behind our back through the stream
+        invalidate(path);
+    }
+    return _inner->open(path, mode);
+}
+
+bool cachingFileSystemProvider::remove(const char *path)
+{
+    scopedLock guard(this);
+    invalidate(path);
+    return ensureMounted() && _inner->remove(path);
+}
+
+bool cachingFileSystemProvider::exists(const char *path)
+{
+    scopedLock guard(this);
+    if (find(path))
+    {
+        return true;
+    }
+    return ensureMounted() && _inner->exists(path);
+}
+
+bool cachingFileSystemProvider::mkdir(const char *path)
+{
+    scopedLock guard(this);
+    return ensureMounted() && _inner->mkdir(path);
+}
+
+String cachingFileSystemProvider::readFile(const char *path)
+{
+    scopedLock guard(this);
+    cacheEntry* entry = find(path);
+    if (entry)
+    {
+        _hits++;
+        entry->lastUse = ++_useCounter;
+        return entry->content;
+    }
+
+    _misses++;
+    if (!ensureMounted())
+    {
+        return String();
+    }
+    String content = _inner->readFile(path);
+    if (!content.isEmpty())
+    {
+        store(path, content);
+    }
+    return content;
+}
+
+size_t cachingFileSystemProvider::writeFile(const char *path, const String &content)
+{
+    scopedLock guard(this);
+    invalidate(path);
+    if (!ensureMounted())
+    {
+        return 0;
+    }
+    const size_t written = _inner->writeFile(path, content);
+    if (written == content.length() && written > 0)
+    {
+        store(path, content);
+    }
+    return written;
+}
+
+void cachingFileSystemProvider::invalidate(const char *path)
+{
+    scopedLock guard(this);
+    if (!path)
+    {
+        return;
+    }
+    for (auto it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (it->path == path)
+        {
+            _cachedBytes -= it->content.length();
+            _entries.erase(it);
+            return;
+        }
+    }
+}
+
+void cachingFileSystemProvider::clear()
+{
+    scopedLock guard(this);
+    _entries.clear();
+    _cachedBytes = 0;
+}
+
+uint32_t cachingFileSystemProvider::getHits() const
+{
+    scopedLock guard(this);
+    return _hits;
+}
+
+uint32_t cachingFileSystemProvider::getMisses() const
+{
+    scopedLock guard(this);
+    return _misses;
+}
+
+size_t cachingFileSystemProvider::getCachedBytes() const
+{
+    scopedLock guard(this);
+    return _cachedBytes;
+}
+
+size_t cachingFileSystemProvider::getCachedEntries() const
+{
+    scopedLock guard(this);
+    return _entries.size();
+}
+
+void cachingFileSystemProvider::resetStats()
+{
+    scopedLock guard(this);
+    _hits = 0;
+    _misses = 0;
+}
+
+bool cachingFileSystemProvider::ensureMounted()
+{
+    if (!_inner)
+    {
+        return false;
+    }
+    if (!_innerMounted)
+    {
+        _innerMounted = _inner->begin();
+    }
+    return _innerMounted;
+}
+
+cachingFileSystemProvider::cacheEntry* cachingFileSystemProvider::find(const char *path)
+{
+    if (!path)
+    {
+        return nullptr;
+    }
+    for (auto &entry : _entries)
+    {
+        if (entry.path == path)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void cachingFileSystemProvider::store(const char *path, const String &content)
+{
+    if (!path || content.length() > _maxBytes || _maxEntries == 0)
+    {
+        return;
+    }
+
+    invalidate(path);
+    while (!_entries.empty() && (_entries.size() >= _maxEntries || _cachedBytes + content.length() > _maxBytes))
+    {
+        auto oldest = _entries.begin();
+        for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            if (it->lastUse < oldest->lastUse)
+            {
+                oldest = it;
+            }
+        }
+        _cachedBytes -= oldest->content.length();
+        _entries.erase(oldest);
+    }
+
+    cacheEntry entry;
+    entry.path = path;
+    entry.content = content;
+    entry.lastUse = ++_useCounter;
+    _entries.push_back(entry);
+    _cachedBytes += content.length();
+}
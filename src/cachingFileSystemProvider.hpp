@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Arduino.h>
+#include <interface/iFileSystemProvider.hpp>
+#include <vector>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(CONFIGMGR_NATIVE)
+#include <mutex>
+#endif
+
+const size_t DEFAULT_FILE_CACHE_MAX_BYTES = 8192; // Matches configManager default maxConfigSize
+const uint8_t DEFAULT_FILE_CACHE_MAX_ENTRIES = 4;
+
+/**
+ * @brief Read-through cache decorator for whole-file loads.
+ *
+ * Keeps the contents of recently read or written files in RAM (bounded by
+ * total bytes and entry count, least recently used evicted first) so
+ * repeated readFile() calls for the same small file cost no flash access.
+ * Entries are refreshed by writeFile() and dropped by remove() or by opening
+ * the file for writing through this provider; changes made to the
+ * underlying filesystem by other means are not seen.
+ *
+ * Mounting is deferred: begin() does not touch the wrapped provider, which
+ * is mounted on the first call that actually needs the flash, so a
+ * cached configManager::loadConfig() neither mounts nor reads.
+ *
+ * The cache is shared by the async save worker and foreground loads, so
+ * every call holds a recursive lock (a FreeRTOS mutex on ESP32); a cache
+ * miss keeps it while the wrapped provider reads.
+ *
+ * Usage:
+ *   littleFSProvider flash;
+ *   cachingFileSystemProvider cache(&flash);
+ *   configManager wifi(&cache, "/wifi.json");
+ *   configManager state(&cache, "/savedState.json");
+ */
+class cachingFileSystemProvider : public iFileSystemProvider
+{
+public:
+    explicit cachingFileSystemProvider(iFileSystemProvider* inner,
+                                       size_t maxBytes = DEFAULT_FILE_CACHE_MAX_BYTES,
+                                       uint8_t maxEntries = DEFAULT_FILE_CACHE_MAX_ENTRIES);
+    ~cachingFileSystemProvider();
+
+    bool begin() override;
+    bool end() override;
+    fs::File open(const char *path, const char *mode) override;
+    bool remove(const char *path) override;
+    bool exists(const char *path) override;
+    bool mkdir(const char *path) override;
+    size_t blockSize() override { return _inner ? _inner->blockSize() : DEFAULT_FS_BLOCK_SIZE; }
+    String readFile(const char *path) override;
+    size_t writeFile(const char *path, const String &content) override;
+
+    // Cache control
+    void invalidate(const char *path);
+    void clear();
+
+    // Cache statistics
+    uint32_t getHits() const;
+    uint32_t getMisses() const;
+    size_t getCachedBytes() const;
+    size_t getCachedEntries() const;
+    void resetStats();
+
+private:
+    struct cacheEntry {
+        String path;
+        String content;
+        uint32_t lastUse;
+    };
+
+    // Held for the duration of each public call; recursive because they call each other
+    class scopedLock {
+    public:
+        explicit scopedLock(const cachingFileSystemProvider* cache);
+        ~scopedLock();
+    private:
+        scopedLock(const scopedLock&) = delete;
+        scopedLock& operator=(const scopedLock&) = delete;
+        const cachingFileSystemProvider* _cache;
+    };
+
+    cachingFileSystemProvider(const cachingFileSystemProvider&) = delete;
+    cachingFileSystemProvider& operator=(const cachingFileSystemProvider&) = delete;
+
+    bool ensureMounted();
+    cacheEntry* find(const char *path);
+    void store(const char *path, const String &content);
+
+    iFileSystemProvider* _inner;
+    const size_t _maxBytes;
+    const uint8_t _maxEntries;
+    std::vector<cacheEntry> _entries;
+    size_t _cachedBytes;
+    uint32_t _useCounter;
+    uint32_t _hits;
+    uint32_t _misses;
+    bool _innerMounted;
+#if defined(ESP32)
+    SemaphoreHandle_t _mutex;
+#elif defined(CONFIGMGR_NATIVE)
+    mutable std::recursive_mutex _mutex;
+#endif
+};
@@ -19,6 +19,7 @@ inline const void* pgm_read_ptr(const void* p){ return p; }
 class Print {
 public:
 	virtual size_t write(uint8_t c){ std::cout << (char)c; return 1; }
+	virtual size_t write(const uint8_t* buffer, size_t size){ size_t n = 0; while (size--) n += write(*buffer++); return n; }
 	size_t print(const String& s){ std::cout << s; return s.length(); }
 	size_t println(const String& s){ std::cout << s << std::endl; return s.length()+1; }
 };
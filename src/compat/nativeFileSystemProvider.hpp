@@ -3,10 +3,13 @@
 #include "native_arduino_compat.hpp"
 #include "interface/iFileSystemProvider.hpp"
 #include <unordered_map>
+#include <cerrno>
+#include <sys/stat.h>
 
 class nativeFileSystemProvider : public iFileSystemProvider {
 public:
     bool begin() override { return true; }
+    bool end() override { return true; }
     File open(const char* path, const char* mode) override {
         std::ios::openmode m = std::ios::binary;
         if (mode && mode[0] == 'w') m |= std::ios::out | std::ios::trunc; else m |= std::ios::in;
@@ -14,5 +17,6 @@ public:
     }
     bool remove(const char* path) override { return std::remove(path) == 0; }
     bool exists(const char* path) override { std::ifstream f(path); return f.good(); }
+    bool mkdir(const char* path) override { return path && (::mkdir(path, 0755) == 0 || errno == EEXIST); }
 };
 #endif // CONFIGMGR_NATIVE
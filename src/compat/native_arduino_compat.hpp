@@ -14,6 +14,8 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstdarg>
+#include <memory>
+#include <cstdio>
 
 class String : public std::string {
 public:
@@ -24,6 +26,25 @@ public:
     String(int v) { *this = std::to_string(v); }
     String(long v) { *this = std::to_string(v); }
     String(unsigned long v) { *this = std::to_string(v); }
+    String(unsigned int v) { *this = std::to_string(v); }
+    // As on the Arduino core; also keeps String(int, int) away from the double overload
+    String(int v, unsigned char base) {
+        static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+        if (base < 2 || base > 36) base = 10;
+        unsigned long magnitude = v < 0 ? 0UL - static_cast<unsigned long>(v) : static_cast<unsigned long>(v);
+        std::string digits;
+        do {
+            digits.insert(digits.begin(), DIGITS[magnitude % base]);
+            magnitude /= base;
+        } while (magnitude);
+        *this = (v < 0 ? "-" : "") + digits;
+    }
+    String(double v, unsigned char decimals) {
+        // Worst case: sign, 309 integer digits (DBL_MAX), point, 255 decimals, terminator
+        char buf[1 + 309 + 1 + 255 + 1];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, v);
+        *this = buf;
+    }
     bool isEmpty() const { return empty(); }
     String substring(size_t from, size_t to = std::string::npos) const {
         if (from >= size()) return String("");
@@ -47,6 +68,17 @@ public:
             pos += r.length();
         }
     }
+    int indexOf(const String& s, unsigned int from = 0) const {
+        const size_t pos = find(s, from);
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    bool endsWith(const String& suffix) const {
+        if (suffix.size() > size()) return false;
+        return std::equal(suffix.rbegin(), suffix.rend(), rbegin());
+    }
+    void remove(size_t index, size_t count = std::string::npos) {
+        if (index < size()) erase(index, count);
+    }
     bool concat(const String& other) { append(other); return true; }
     bool concat(const char* s) { if(s) append(s); return true; }
 };
@@ -75,17 +107,70 @@ public:
 };
 static SerialClass Serial;
 
+// Minimal fs::File emulation mirroring the Arduino FileImpl/File split so that
+// native providers can back a File with something other than std::fstream.
+namespace fs {
+
+class FileImpl {
+public:
+    virtual ~FileImpl() = default;
+    virtual size_t write(const uint8_t* buf, size_t size) = 0;
+    virtual size_t read(uint8_t* buf, size_t size) = 0;
+    virtual size_t size() const = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+};
+using FileImplPtr = std::shared_ptr<FileImpl>;
+
+class fstreamFileImpl : public FileImpl {
+    mutable std::fstream _fs;
+public:
+    fstreamFileImpl(const std::string& path, std::ios::openmode mode) { _fs.open(path, mode); }
+    size_t write(const uint8_t* buf, size_t size) override {
+        _fs.write(reinterpret_cast<const char*>(buf), size);
+        return _fs ? size : 0;
+    }
+    size_t read(uint8_t* buf, size_t size) override {
+        _fs.read(reinterpret_cast<char*>(buf), size);
+        return static_cast<size_t>(_fs.gcount());
+    }
+    size_t size() const override {
+        auto here = _fs.tellg();
+        _fs.seekg(0, std::ios::end);
+        auto end = _fs.tellg();
+        _fs.seekg(here);
+        return end < 0 ? 0 : static_cast<size_t>(end);
+    }
+    void close() override { if (_fs.is_open()) _fs.close(); }
+    bool isOpen() const override { return _fs.is_open(); }
+};
+
 class File {
-    std::fstream _fs;
+    FileImplPtr _p;
 public:
-    File() {}
-    File(const std::string& path, std::ios::openmode mode) { _fs.open(path, mode); }
-    operator bool() const { return _fs.is_open(); }
-    String readString() { std::stringstream buffer; buffer << _fs.rdbuf(); return buffer.str(); }
-    size_t print(const String& s) { _fs << s; return s.size(); }
-    void close() { if (_fs.is_open()) _fs.close(); }
+    File(FileImplPtr p = FileImplPtr()) : _p(p) {}
+    File(const std::string& path, std::ios::openmode mode) : _p(std::make_shared<fstreamFileImpl>(path, mode)) {}
+    operator bool() const { return _p && _p->isOpen(); }
+    size_t write(const uint8_t* buf, size_t size) { return *this ? _p->write(buf, size) : 0; }
+    size_t read(uint8_t* buf, size_t size) { return *this ? _p->read(buf, size) : 0; }
+    size_t size() const { return *this ? _p->size() : 0; }
+    String readString() {
+        String out;
+        uint8_t buf[256];
+        size_t n;
+        while ((n = read(buf, sizeof(buf))) > 0) {
+            out.append(reinterpret_cast<const char*>(buf), n);
+        }
+        return out;
+    }
+    size_t print(const String& s) { return write(reinterpret_cast<const uint8_t*>(s.data()), s.size()); }
+    void close() { if (_p) _p->close(); }
 };
 
+} // namespace fs
+
+using fs::File;
+
 #ifndef ARDUINO
 #define ARDUINO 100
 #endif
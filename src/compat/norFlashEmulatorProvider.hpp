@@ -0,0 +1,380 @@
+#pragma once
+#ifdef CONFIGMGR_NATIVE
+#include "native_arduino_compat.hpp"
+#include "interface/iFileSystemProvider.hpp"
+#include <cstring>
+#include <map>
+#include <vector>
+
+// Default geometry: 256 KB part with 4 KB sectors and 256 byte pages,
+// timings taken from typical SPI NOR datasheets (W25Q / GD25Q class)
+const uint32_t DEFAULT_NOR_SECTOR_COUNT = 64;
+const uint32_t DEFAULT_NOR_SECTOR_SIZE = 4096;
+const uint32_t DEFAULT_NOR_PAGE_SIZE = 256;
+const uint32_t DEFAULT_NOR_PAGE_PROGRAM_US = 700;
+const uint32_t DEFAULT_NOR_SECTOR_ERASE_US = 45000;
+const uint32_t DEFAULT_NOR_METADATA_ENTRY_SIZE = 64; // Bytes appended to the metadata log per file commit
+
+/**
+ * @brief Native iFileSystemProvider backed by an emulated NOR flash array.
+ *
+ * Bits can only be programmed from 1 to 0 in page-sized chunks and a sector
+ * must be erased (back to 0xFF) before it can be reprogrammed. Files are
+ * stored copy-on-write the way LittleFS stores them: each rewrite allocates
+ * fresh data sectors round-robin and appends a commit to a pair of metadata
+ * sectors, which are compacted (one erase) when the active one fills up.
+ *
+ * Every page program and sector erase is counted so native tests can report
+ * the exact flash cost of a configManager::saveConfig() and run endurance
+ * loops far beyond what is practical on hardware. Latencies are accumulated
+ * as simulated time instead of being slept, so loops run at host speed.
+ *
+ * Files opened with "w"/"a" are committed to flash on close(); "a" rewrites
+ * the whole file, which matches LittleFS for files smaller than one block.
+ */
+class norFlashEmulatorProvider : public iFileSystemProvider {
+public:
+    struct Stats {
+        uint64_t bytesProgrammed;
+        uint64_t pagesProgrammed;
+        uint64_t sectorsErased;
+        uint64_t bytesRead;
+        uint64_t simulatedBusyMicros;
+        uint32_t fileCommits;
+        uint32_t metadataCompactions;
+        uint32_t programViolations; // Programs that needed a 0 -> 1 transition (missing erase)
+        uint32_t failedWrites;      // Commits rejected because the array was full
+        uint32_t mounts;
+    };
+
+    explicit norFlashEmulatorProvider(uint32_t sectorCount = DEFAULT_NOR_SECTOR_COUNT,
+                                      uint32_t sectorSize = DEFAULT_NOR_SECTOR_SIZE,
+                                      uint32_t pageSize = DEFAULT_NOR_PAGE_SIZE)
+        : _sectorCount(sectorCount < 4 ? 4 : sectorCount)
+        , _sectorSize(sectorSize)
+        , _pageSize(pageSize == 0 || pageSize > sectorSize ? sectorSize : pageSize)
+        , _pageProgramMicros(DEFAULT_NOR_PAGE_PROGRAM_US)
+        , _sectorEraseMicros(DEFAULT_NOR_SECTOR_ERASE_US)
+        , _metadataEntrySize(DEFAULT_NOR_METADATA_ENTRY_SIZE)
+        , _flash(static_cast<size_t>(_sectorCount) * _sectorSize, 0xFF)
+        , _eraseCounts(_sectorCount, 0)
+        , _sectorUsed(_sectorCount, false)
+        , _sectorErased(_sectorCount, true)
+        , _activeMetadata(0)
+        , _metadataOffset(0)
+        , _nextAlloc(METADATA_SECTORS)
+        , _mounted(false) {
+        resetStats();
+        _sectorUsed[0] = true;
+        _sectorUsed[1] = true;
+    }
+
+    // iFileSystemProvider interface implementation
+    bool begin() override {
+        if (!_mounted) {
+            _mounted = true;
+            _stats.mounts++;
+        }
+        return true;
+    }
+
+    bool end() override {
+        _mounted = false;
+        return true;
+    }
+
+    fs::File open(const char* path, const char* mode) override {
+        if (!path) {
+            return fs::File();
+        }
+        const char m = mode ? mode[0] : 'r';
+        if (m == 'w') {
+            return fs::File(std::make_shared<writeImpl>(this, path, String()));
+        }
+        if (m == 'a') {
+            return fs::File(std::make_shared<writeImpl>(this, path, readContent(path)));
+        }
+        if (!exists(path)) {
+            return fs::File();
+        }
+        return fs::File(std::make_shared<readImpl>(readContent(path)));
+    }
+
+    bool remove(const char* path) override {
+        auto it = path ? _files.find(path) : _files.end();
+        if (it == _files.end()) {
+            return false;
+        }
+        releaseSectors(it->second.sectors);
+        _files.erase(it);
+        appendMetadataEntry(path, 0);
+        return true;
+    }
+
+    bool exists(const char* path) override {
+        return path && _files.find(path) != _files.end();
+    }
+
+    // Filesystem-style helpers matching littleFSProvider
+    size_t blockSize() override { return _sectorSize; }
+    size_t totalBytes() const { return static_cast<size_t>(_sectorCount - METADATA_SECTORS) * _sectorSize; }
+    size_t usedBytes() const {
+        size_t used = 0;
+        for (const auto& file : _files) {
+            used += file.second.sectors.size() * _sectorSize;
+        }
+        return used;
+    }
+
+    bool format() {
+        for (uint32_t s = 0; s < _sectorCount; s++) {
+            eraseSector(s);
+            _sectorUsed[s] = s < METADATA_SECTORS;
+        }
+        _files.clear();
+        _activeMetadata = 0;
+        _metadataOffset = 0;
+        _nextAlloc = METADATA_SECTORS;
+        return true;
+    }
+
+    // Emulation control
+    void setLatency(uint32_t pageProgramMicros, uint32_t sectorEraseMicros) {
+        _pageProgramMicros = pageProgramMicros;
+        _sectorEraseMicros = sectorEraseMicros;
+    }
+    void setMetadataEntrySize(uint32_t bytes) {
+        _metadataEntrySize = (bytes == 0 || bytes > _sectorSize) ? DEFAULT_NOR_METADATA_ENTRY_SIZE : bytes;
+    }
+
+    // Wear and traffic inspection
+    const Stats& getStats() const { return _stats; }
+    void resetStats() { _stats = Stats{}; }
+
+    uint32_t getSectorCount() const { return _sectorCount; }
+    uint32_t getSectorSize() const { return _sectorSize; }
+    uint32_t getPageSize() const { return _pageSize; }
+    uint32_t getSectorEraseCount(uint32_t sector) const { return sector < _sectorCount ? _eraseCounts[sector] : 0; }
+    uint32_t getMaxSectorEraseCount() const { return *std::max_element(_eraseCounts.begin(), _eraseCounts.end()); }
+    uint32_t getMinSectorEraseCount() const { return *std::min_element(_eraseCounts.begin(), _eraseCounts.end()); }
+    uint32_t getFreeSectors() const {
+        return static_cast<uint32_t>(std::count(_sectorUsed.begin(), _sectorUsed.end(), false));
+    }
+    size_t getFileCount() const { return _files.size(); }
+
+    void printWearMap() const {
+        Serial.println("=== NOR Flash Emulator Wear Map ===");
+        for (uint32_t s = 0; s < _sectorCount; s++) {
+            Serial.printf("%4u%s", static_cast<unsigned>(_eraseCounts[s]), (s % 16 == 15) ? "\n" : " ");
+        }
+        Serial.printf("Programmed: %llu bytes in %llu pages, erased: %llu sectors, busy: %llu us\n",
+                      static_cast<unsigned long long>(_stats.bytesProgrammed),
+                      static_cast<unsigned long long>(_stats.pagesProgrammed),
+                      static_cast<unsigned long long>(_stats.sectorsErased),
+                      static_cast<unsigned long long>(_stats.simulatedBusyMicros));
+        Serial.println("===================================");
+    }
+
+private:
+    static const uint32_t METADATA_SECTORS = 2;
+
+    struct fileEntry {
+        std::vector<uint32_t> sectors;
+        size_t size;
+    };
+
+    class readImpl : public fs::FileImpl {
+        String _content;
+        size_t _pos;
+        bool _open;
+    public:
+        explicit readImpl(const String& content) : _content(content), _pos(0), _open(true) {}
+        size_t write(const uint8_t*, size_t) override { return 0; }
+        size_t read(uint8_t* buf, size_t size) override {
+            size_t n = std::min(size, _content.size() - _pos);
+            memcpy(buf, _content.data() + _pos, n);
+            _pos += n;
+            return n;
+        }
+        size_t size() const override { return _content.size(); }
+        void close() override { _open = false; }
+        bool isOpen() const override { return _open; }
+    };
+
+    class writeImpl : public fs::FileImpl {
+        norFlashEmulatorProvider* _owner;
+        String _path;
+        String _buffer;
+        bool _open;
+    public:
+        writeImpl(norFlashEmulatorProvider* owner, const char* path, const String& initial)
+            : _owner(owner), _path(path), _buffer(initial), _open(true) {}
+        ~writeImpl() override { close(); }
+        size_t write(const uint8_t* buf, size_t size) override {
+            if (!_open) return 0;
+            _buffer.append(reinterpret_cast<const char*>(buf), size);
+            return size;
+        }
+        size_t read(uint8_t*, size_t) override { return 0; }
+        size_t size() const override { return _buffer.size(); }
+        void close() override {
+            if (_open) {
+                _open = false;
+                _owner->commitFile(_path, _buffer);
+            }
+        }
+        bool isOpen() const override { return _open; }
+    };
+
+    String readContent(const char* path) {
+        auto it = _files.find(path);
+        if (it == _files.end()) {
+            return String();
+        }
+        String out;
+        out.reserve(it->second.size);
+        size_t remaining = it->second.size;
+        for (uint32_t sector : it->second.sectors) {
+            size_t chunk = std::min<size_t>(remaining, _sectorSize);
+            out.append(reinterpret_cast<const char*>(&_flash[static_cast<size_t>(sector) * _sectorSize]), chunk);
+            remaining -= chunk;
+        }
+        _stats.bytesRead += out.size();
+        return out;
+    }
+
+    bool commitFile(const String& path, const String& content) {
+        const uint32_t needed = static_cast<uint32_t>((content.size() + _sectorSize - 1) / _sectorSize);
+        auto existing = _files.find(path);
+        if (needed > getFreeSectors()) {
+            // Copy-on-write needs the new copy in place before the old one is released
+            _stats.failedWrites++;
+            return false;
+        }
+
+        fileEntry entry;
+        entry.size = content.size();
+        for (uint32_t i = 0; i < needed; i++) {
+            const uint32_t sector = allocateSector();
+            const size_t offset = static_cast<size_t>(i) * _sectorSize;
+            program(sector, 0, reinterpret_cast<const uint8_t*>(content.data()) + offset,
+                    std::min<size_t>(_sectorSize, content.size() - offset));
+            entry.sectors.push_back(sector);
+        }
+
+        if (existing != _files.end()) {
+            releaseSectors(existing->second.sectors);
+            existing->second = entry;
+        } else {
+            _files.emplace(path, entry);
+        }
+        appendMetadataEntry(path.c_str(), content.size());
+        _stats.fileCommits++;
+        return true;
+    }
+
+    uint32_t allocateSector() {
+        // Round-robin scan from the last allocation, like the LittleFS lookahead allocator
+        const uint32_t dataSectors = _sectorCount - METADATA_SECTORS;
+        for (uint32_t n = 0; n < dataSectors; n++) {
+            const uint32_t sector = METADATA_SECTORS + (_nextAlloc - METADATA_SECTORS + n) % dataSectors;
+            if (!_sectorUsed[sector]) {
+                _nextAlloc = METADATA_SECTORS + (sector - METADATA_SECTORS + 1) % dataSectors;
+                _sectorUsed[sector] = true;
+                if (!_sectorErased[sector]) {
+                    eraseSector(sector);
+                }
+                return sector;
+            }
+        }
+        return 0; // Unreachable: callers check getFreeSectors() first
+    }
+
+    void releaseSectors(const std::vector<uint32_t>& sectors) {
+        for (uint32_t sector : sectors) {
+            _sectorUsed[sector] = false;
+        }
+    }
+
+    void appendMetadataEntry(const char* path, size_t size) {
+        if (_metadataOffset + _metadataEntrySize > _sectorSize) {
+            compactMetadata();
+        }
+        programMetadataEntry(_activeMetadata, _metadataOffset, path, size);
+        _metadataOffset += _metadataEntrySize;
+    }
+
+    void compactMetadata() {
+        const uint32_t target = _activeMetadata ^ 1;
+        eraseSector(target);
+        uint32_t offset = 0;
+        for (const auto& file : _files) {
+            if (offset + _metadataEntrySize > _sectorSize) {
+                break; // Directory larger than one metadata sector; real LittleFS would split the pair
+            }
+            programMetadataEntry(target, offset, file.first.c_str(), file.second.size);
+            offset += _metadataEntrySize;
+        }
+        _activeMetadata = target;
+        _metadataOffset = offset;
+        _stats.metadataCompactions++;
+    }
+
+    void programMetadataEntry(uint32_t sector, uint32_t offset, const char* path, size_t size) {
+        std::vector<uint8_t> entry(_metadataEntrySize, 0xFF);
+        const uint32_t size32 = static_cast<uint32_t>(size);
+        memcpy(entry.data(), &size32, std::min<size_t>(sizeof(size32), entry.size()));
+        const size_t nameLen = std::min<size_t>(strlen(path), entry.size() > 4 ? entry.size() - 4 : 0);
+        memcpy(entry.data() + 4, path, nameLen);
+        program(sector, offset, entry.data(), entry.size());
+    }
+
+    void program(uint32_t sector, uint32_t offset, const uint8_t* data, size_t len) {
+        uint8_t* base = &_flash[static_cast<size_t>(sector) * _sectorSize];
+        size_t done = 0;
+        while (done < len) {
+            const uint32_t pos = offset + static_cast<uint32_t>(done);
+            const size_t chunk = std::min<size_t>(len - done, _pageSize - (pos % _pageSize));
+            for (size_t i = 0; i < chunk; i++) {
+                if ((base[pos + i] & data[done + i]) != data[done + i]) {
+                    _stats.programViolations++;
+                }
+                base[pos + i] &= data[done + i];
+            }
+            _stats.pagesProgrammed++;
+            _stats.bytesProgrammed += chunk;
+            _stats.simulatedBusyMicros += _pageProgramMicros;
+            done += chunk;
+        }
+        _sectorErased[sector] = false;
+    }
+
+    void eraseSector(uint32_t sector) {
+        std::fill_n(_flash.begin() + static_cast<size_t>(sector) * _sectorSize, _sectorSize, 0xFF);
+        _eraseCounts[sector]++;
+        _sectorErased[sector] = true;
+        _stats.sectorsErased++;
+        _stats.simulatedBusyMicros += _sectorEraseMicros;
+    }
+
+    const uint32_t _sectorCount;
+    const uint32_t _sectorSize;
+    const uint32_t _pageSize;
+    uint32_t _pageProgramMicros;
+    uint32_t _sectorEraseMicros;
+    uint32_t _metadataEntrySize;
+
+    std::vector<uint8_t> _flash;
+    std::vector<uint32_t> _eraseCounts;
+    std::vector<bool> _sectorUsed;
+    std::vector<bool> _sectorErased;
+    std::map<String, fileEntry> _files;
+
+    uint32_t _activeMetadata;
+    uint32_t _metadataOffset;
+    uint32_t _nextAlloc;
+    bool _mounted;
+    Stats _stats;
+};
+
+#endif // CONFIGMGR_NATIVE
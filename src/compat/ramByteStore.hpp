@@ -0,0 +1,62 @@
+#pragma once
+#ifdef CONFIGMGR_NATIVE
+#include "native_arduino_compat.hpp"
+#include "interface/iByteStore.hpp"
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief Native iByteStore held in RAM, optionally backed by a file.
+ *
+ * Erased bytes read 0xFF like a fresh EEPROM emulation. With a path the
+ * image is loaded by begin() and rewritten by every commit(), so counters
+ * survive across native runs; without one the store lives only as long as
+ * the object. Commits and changed bytes are counted for benchmarks, and the
+ * image is directly accessible to tests that corrupt or inspect records.
+ */
+class ramByteStore : public iByteStore {
+public:
+    explicit ramByteStore(const char* path = nullptr) : _path(path ? path : ""), _commits(0), _bytesChanged(0) {}
+
+    bool begin(size_t size) override {
+        if (_data.size() == size) return true;
+        _data.assign(size, 0xFF);
+        if (!_path.empty()) {
+            FILE* f = std::fopen(_path.c_str(), "rb");
+            if (f) {
+                size_t got = std::fread(_data.data(), 1, size, f);
+                (void)got;
+                std::fclose(f);
+            }
+        }
+        return true;
+    }
+    size_t length() const override { return _data.size(); }
+    uint8_t read(size_t address) const override { return address < _data.size() ? _data[address] : 0xFF; }
+    void write(size_t address, uint8_t value) override {
+        if (address >= _data.size() || _data[address] == value) return;
+        _data[address] = value;
+        _bytesChanged++;
+    }
+    bool commit() override {
+        _commits++;
+        if (_path.empty()) return true;
+        FILE* f = std::fopen(_path.c_str(), "wb");
+        if (!f) return false;
+        bool ok = std::fwrite(_data.data(), 1, _data.size(), f) == _data.size();
+        std::fclose(f);
+        return ok;
+    }
+
+    uint8_t* data() { return _data.data(); }
+    uint64_t getCommitCount() const { return _commits; }
+    uint64_t getBytesChanged() const { return _bytesChanged; }
+    void resetStats() { _commits = 0; _bytesChanged = 0; }
+
+private:
+    std::string _path;
+    std::vector<uint8_t> _data;
+    uint64_t _commits;
+    uint64_t _bytesChanged;
+};
+#endif // CONFIGMGR_NATIVE
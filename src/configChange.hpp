@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Arduino.h>
+#include <spscQueue.hpp>
+
+class configManager;
+
+const uint16_t CONFIG_CHANGE_QUEUE_DEPTH = 16;   // Events a configChangeQueue holds before dropping
+
+/**
+ * @brief Change notification for configManager::subscribe().
+ *
+ * Fired after an effective change (a value that differs, a key or section
+ * that appears or disappears) made by setValue(), loadConfig(),
+ * loadSection(), clearConfig() or a transaction commit. Callbacks run in
+ * the task that made the change, after the config lock is released, so they
+ * may read the config; key is the changed key (a section-wide subscription
+ * gets one call per changed key).
+ */
+typedef void (*configChangeCallback)(configManager* config, const String& section, const String& key, void* context);
+
+// Queued form: the consumer learns which subscription fired and reads the value itself
+struct configChangeEvent {
+    uint16_t subscriptionId;
+};
+
+typedef spscQueue<configChangeEvent, CONFIG_CHANGE_QUEUE_DEPTH> configChangeQueue;
@@ -0,0 +1,73 @@
+#include <configJsonWriter.hpp>
+
+void configJsonWriter::raw(char c)
+{
+    if (_used == CONFIG_EXPORT_BUFFER_SIZE)
+    {
+        flush();
+    }
+    _buffer[_used++] = c;
+}
+
+void configJsonWriter::raw(const char *text)
+{
+    while (*text)
+    {
+        raw(*text++);
+    }
+}
+
+void configJsonWriter::string(const String &text)
+{
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    raw('"');
+    const char *p = text.c_str();
+    for (size_t i = 0; i < text.length(); i++)
+    {
+        const char c = p[i];
+        switch (c)
+        {
+        case '"':
+            raw("\\\"");
+            break;
+        case '\\':
+            raw("\\\\");
+            break;
+        case '\n':
+            raw("\\n");
+            break;
+        case '\r':
+            raw("\\r");
+            break;
+        case '\t':
+            raw("\\t");
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                raw("\\u00");
+                raw(HEX_DIGITS[(c >> 4) & 0x0F]);
+                raw(HEX_DIGITS[c & 0x0F]);
+            }
+            else
+            {
+                // UTF-8 passes through unchanged
+                raw(c);
+            }
+            break;
+        }
+    }
+    raw('"');
+}
+
+size_t configJsonWriter::flush()
+{
+    if (_used > 0 && !_failed)
+    {
+        const size_t accepted = _out.write(reinterpret_cast<const uint8_t *>(_buffer), _used);
+        _written += accepted;
+        _failed = accepted < _used;
+    }
+    _used = 0;
+    return _written;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Arduino.h>
+
+const size_t CONFIG_EXPORT_BUFFER_SIZE = 64;   // Stack buffer between the JSON writer and the Print sink
+
+/**
+ * @brief Writes JSON text to an Arduino Print through a fixed stack buffer.
+ *
+ * Output is collected in CONFIG_EXPORT_BUFFER_SIZE bytes and handed to the
+ * sink with Print::write(buffer, size) whenever the buffer fills, so the
+ * memory used does not depend on how much JSON is produced. Once the sink
+ * accepts fewer bytes than offered (a web client went away, a file is full)
+ * the writer stops sending and isFailed() turns true.
+ *
+ * Used by configManager::exportJson(); the caller takes care of JSON
+ * structure, string() takes care of quoting and escaping.
+ */
+class configJsonWriter
+{
+public:
+    explicit configJsonWriter(Print& out) : _out(out), _used(0), _written(0), _failed(false) {}
+    ~configJsonWriter() { flush(); }
+
+    void raw(char c);
+    void raw(const char* text);
+    void string(const String& text);     // Quoted, with JSON escapes
+
+    // Sends what is buffered; returns bytes accepted by the sink so far
+    size_t flush();
+    size_t getWritten() const { return _written; }
+    bool isFailed() const { return _failed; }
+
+private:
+    configJsonWriter(const configJsonWriter&) = delete;
+    configJsonWriter& operator=(const configJsonWriter&) = delete;
+
+    Print& _out;
+    char _buffer[CONFIG_EXPORT_BUFFER_SIZE];
+    size_t _used;
+    size_t _written;
+    bool _failed;
+};
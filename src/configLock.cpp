@@ -0,0 +1,67 @@
+#include <configLock.hpp>
+
+configLock::configLock()
+{
+#if defined(ESP32)
+    _readerMutex = xSemaphoreCreateMutex();
+    _writeSemaphore = xSemaphoreCreateBinary();
+    _readers = 0;
+    xSemaphoreGive(_writeSemaphore);
+#endif
+}
+
+configLock::~configLock()
+{
+#if defined(ESP32)
+    vSemaphoreDelete(_writeSemaphore);
+    vSemaphoreDelete(_readerMutex);
+#endif
+}
+
+void configLock::lockShared()
+{
+#if defined(ESP32)
+    xSemaphoreTake(_readerMutex, portMAX_DELAY);
+    if (++_readers == 1)
+    {
+        // First reader in keeps writers out for the whole group
+        xSemaphoreTake(_writeSemaphore, portMAX_DELAY);
+    }
+    xSemaphoreGive(_readerMutex);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.lock_shared();
+#endif
+}
+
+void configLock::unlockShared()
+{
+#if defined(ESP32)
+    xSemaphoreTake(_readerMutex, portMAX_DELAY);
+    if (--_readers == 0)
+    {
+        // A binary semaphore, not a mutex: the last reader out need not be the first one in
+        xSemaphoreGive(_writeSemaphore);
+    }
+    xSemaphoreGive(_readerMutex);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.unlock_shared();
+#endif
+}
+
+void configLock::lock()
+{
+#if defined(ESP32)
+    xSemaphoreTake(_writeSemaphore, portMAX_DELAY);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.lock();
+#endif
+}
+
+void configLock::unlock()
+{
+#if defined(ESP32)
+    xSemaphoreGive(_writeSemaphore);
+#elif defined(CONFIGMGR_NATIVE)
+    _mutex.unlock();
+#endif
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Arduino.h>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(CONFIGMGR_NATIVE)
+#include <shared_mutex>
+#endif
+
+/**
+ * @brief Reader-writer lock guarding a configManager's in-memory map.
+ *
+ * Any number of readers hold it together; a writer holds it alone. On ESP32
+ * it is built from two FreeRTOS semaphores (a mutex for the reader count and
+ * a binary semaphore the first reader takes for the group and the last one
+ * gives back), on native it is a std::shared_mutex. Platforms without a
+ * threading layer (ESP8266) get a lock that does nothing.
+ *
+ * The ESP32 lock prefers readers: a steady stream of overlapping readers can
+ * hold off a writer, which suits configuration (read constantly, written
+ * rarely). It is not recursive; a task holding it must not take it again.
+ */
+class configLock
+{
+public:
+    configLock();
+    ~configLock();
+
+    void lockShared();
+    void unlockShared();
+    void lock();
+    void unlock();
+
+private:
+    configLock(const configLock&) = delete;
+    configLock& operator=(const configLock&) = delete;
+
+#if defined(ESP32)
+    SemaphoreHandle_t _readerMutex;
+    SemaphoreHandle_t _writeSemaphore;
+    uint16_t _readers;
+#elif defined(CONFIGMGR_NATIVE)
+    std::shared_mutex _mutex;
+#endif
+};
+
+// Scoped holders; a null lock (concurrency not enabled) makes them no-ops
+class configSharedGuard
+{
+public:
+    explicit configSharedGuard(configLock* lock) : _lock(lock) { if (_lock) _lock->lockShared(); }
+    ~configSharedGuard() { if (_lock) _lock->unlockShared(); }
+
+private:
+    configSharedGuard(const configSharedGuard&) = delete;
+    configSharedGuard& operator=(const configSharedGuard&) = delete;
+    configLock* _lock;
+};
+
+class configExclusiveGuard
+{
+public:
+    explicit configExclusiveGuard(configLock* lock) : _lock(lock) { if (_lock) _lock->lock(); }
+    ~configExclusiveGuard() { if (_lock) _lock->unlock(); }
+
+private:
+    configExclusiveGuard(const configExclusiveGuard&) = delete;
+    configExclusiveGuard& operator=(const configExclusiveGuard&) = delete;
+    configLock* _lock;
+};
@@ -29,17 +29,18 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include <algorithm>
+#include <functional>
 #include <map>
+#include <random>
 #include <utility>
 #include <vector>
 
 #include <configManager.hpp>
 
+#include "fileSystemSession.hpp"
 #include "flashWearCounter.hpp"
-
-// Static member definitions
-std::map<String, configManager*> configManager::_domainRegistry;
-configManager* configManager::_defaultDomain = nullptr;
+#include "parallelRunner.hpp"
 
 namespace
 {
@@ -241,6 +242,24 @@ namespace
   }
 }
 )rawlite";
+
+    uint32_t newVersionEpoch()
+    {
+#if defined(CONFIGMGR_NATIVE)
+        return std::random_device()();
+#elif defined(ESP32)
+        return esp_random();
+#else
+        return RANDOM_REG32;   // ESP8266 hardware RNG
+#endif
+    }
+
+    String formatETag(uint32_t epoch, uint32_t version)
+    {
+        char tag[24];
+        snprintf(tag, sizeof(tag), "\"%08lx-%lu\"", static_cast<unsigned long>(epoch), static_cast<unsigned long>(version));
+        return String(tag);
+    }
 }
 
 configManager::configManager(iFileSystemProvider *fsProvider, const String &configFilePath, size_t maxConfigSize) :
@@ -248,12 +267,26 @@ configManager::configManager(iFileSystemProvider *fsProvider, const String &conf
     _maxConfigSize(maxConfigSize),
     _configFilePath(configFilePath),
     _isConfigLoaded(false),
+    _storageLayout(CONFIG_LAYOUT_SINGLE_FILE),
+    _writeGovernor(nullptr),
+    _saveDeferred(false),
+    _savesDeferred(0),
+    _savesCoalesced(0),
+    _lock(nullptr),
+    _snapshotsEnabled(false),
+    _viewVersion(0),
+    _changeVersion(0),
+    _versionEpoch(newVersionEpoch()),
+    _nextSubscriptionId(1),
+    _updatesApplied(0),
+    _updatesRejected(0),
     _domainName(""),
-    _isDefaultDomain(false)
+    _isDefaultDomain(false),
+    _domainId(DOMAIN_ID_NONE)
 {
 }
 
-bool configManager::begin(String filename, bool verbose)
+bool configManager::begin(String filename, bool verbose, std::vector<notification>* notifications)
 {
     if (filename.isEmpty())
     {
@@ -264,63 +297,149 @@ bool configManager::begin(String filename, bool verbose)
         return false;
     }
 
-    _configFilePath = filename;
-    String jsonString;
-    _configMap.clear();
+    {
+        configExclusiveGuard guard(_lock);
+        _configFilePath = filename;
+    }
 
-    if (!_fsProvider || !_fsProvider->begin())
+    // Readers keep the previous map until the new one is installed
+    storedConfig stored;
     {
-        if (verbose)
+        fileSystemSession session(_fsProvider);
+        if (!session.isMounted())
+        {
+            if (verbose)
+            {
+                LOG_ERROR(LOG_CAT_CONFIG, "Filesystem mount failed. Loading defaults...");
+            }
+            stored.json = loadDefaults();
+        }
+        else
         {
-            LOG_ERROR(LOG_CAT_CONFIG, "Filesystem mount failed. Loading defaults...");
+            if (verbose)
+            {
+                LOG_INFO(LOG_CAT_CONFIG, "Filesystem mounted");
+            }
+            readStored(stored, verbose);
         }
-        jsonString = loadDefaults();
     }
-    else
+
+    parseStored(stored, verbose);
+    return installStored(stored, verbose, notifications);
+}
+
+void configManager::readStored(storedConfig &stored, bool verbose)
+{
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
     {
+        // The manifest is tiny; parsing it here tells which shard files to read
+        const String manifestJson = _fsProvider->readFile(getShardManifestPath().c_str());
+        std::map<String, std::map<String, String>> manifestMap;
+        if (!manifestJson.isEmpty() && jsonStringToMap(manifestJson, manifestMap, verbose))
+        {
+            auto files = manifestMap.find("manifest");
+            if (files != manifestMap.end())
+            {
+                stored.fromShards = true;
+                for (const auto &entry : files->second)
+                {
+                    String shardJson = _fsProvider->readFile(entry.second.c_str());
+                    stored.bytes += shardJson.length();
+                    stored.shards.emplace_back(entry.first, std::move(shardJson));
+                }
+                return;
+            }
+        }
         if (verbose)
         {
-            LOG_INFO(LOG_CAT_CONFIG, "Filesystem mounted");
+            LOG_WARN(LOG_CAT_CONFIG, "No shard manifest in %s, reading single config file", _shardDirectory.c_str());
         }
+    }
+
+    if (loadConfigString(_configFilePath.c_str(), &stored.json, verbose))
+    {
+        stored.bytes = stored.json.length();
+    }
+    else if (verbose)
+    {
+        LOG_WARN(LOG_CAT_CONFIG, "Failed to read config file. Loading defaults...");
+    }
+}
 
-        if (!loadConfigString(filename.c_str(), &jsonString, verbose))
+void configManager::parseStored(storedConfig &stored, bool verbose)
+{
+    // Touches nothing but stored, so different configs parse in parallel
+    if (stored.fromShards)
+    {
+        std::map<String, std::map<String, String>> shard;
+        for (const auto &entry : stored.shards)
         {
-            if (verbose)
+            if (entry.second.isEmpty() || !jsonStringToMap(entry.second, shard, verbose))
             {
-                LOG_WARN(LOG_CAT_CONFIG, "Failed to read config file. Loading defaults...");
+                LOG_WARN(LOG_CAT_CONFIG, "Config shard missing or corrupt for section %s", entry.first.c_str());
+                stored.dirtySections.insert(entry.first);
+                stored.map[entry.first];
+                continue;
             }
-            jsonString = loadDefaults();
+            auto section = shard.find(entry.first);
+            stored.map[entry.first] = (section != shard.end()) ? std::move(section->second) : std::map<String, String>();
+            stored.shardSections.insert(entry.first);
         }
-
-        _fsProvider->end();
+        stored.shards.clear();
         if (verbose)
         {
-            LOG_INFO(LOG_CAT_CONFIG, "Filesystem unmounted");
+            LOG_INFO(LOG_CAT_CONFIG, "Loaded %u config shards from %s", static_cast<unsigned int>(stored.shardSections.size()), _shardDirectory.c_str());
         }
+        return;
     }
 
-    if (verbose && !jsonString.isEmpty())
+    if (verbose && !stored.json.isEmpty())
     {
         LOG_INFO(LOG_CAT_CONFIG, "Raw config string:");
-        LOG_INFO(LOG_CAT_CONFIG, jsonString.c_str());
+        LOG_INFO(LOG_CAT_CONFIG, stored.json.c_str());
     }
 
-    if (!jsonStringToConfig(jsonString, verbose))
+    if (!jsonStringToMap(stored.json, stored.map, verbose))
     {
         if (verbose)
         {
             LOG_WARN(LOG_CAT_CONFIG, "JSON parsing failed. Loading defaults...");
         }
-        jsonString = loadDefaults();
-        jsonStringToConfig(jsonString, verbose);
+        jsonStringToMap(loadDefaults(), stored.map, verbose);
+    }
+    stored.json = String();
+
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+    {
+        // Migrated from the single file or defaults: every shard needs writing
+        for (const auto &section : stored.map)
+        {
+            stored.dirtySections.insert(section.first);
+        }
+    }
+}
+
+bool configManager::installStored(storedConfig &stored, bool verbose, std::vector<notification> *notifications)
+{
+    configExclusiveGuard guard(_lock);
+    std::map<String, std::map<String, String>> previous;
+    previous.swap(_configMap);
+    _configMap.swap(stored.map);
+    _dirtySections.swap(stored.dirtySections);
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+    {
+        _shardSections.swap(stored.shardSections);
     }
 
     if (verbose)
     {
         LOG_INFO(LOG_CAT_CONFIG, "Loaded %u config sections", static_cast<unsigned int>(_configMap.size()));
-        printConfigToSerial();
+        printConfigMap();
     }
 
+    publishView(nullptr);
+    std::vector<notification> unused;
+    bumpVersion(diffSections(previous, true, notifications ? *notifications : unused));
     _isConfigLoaded = !_configMap.empty();
     return _isConfigLoaded;
 }
@@ -349,25 +468,12 @@ bool configManager::loadConfigString(const char *filename, String *jsonString, b
         return false;
     }
 
-    fs::File file = _fsProvider->open(filename, "r");
-    if (!file)
-    {
-        if (verbose)
-        {
-            LOG_ERROR(LOG_CAT_CONFIG, "Failed to open config file. Falling back to defaults.");
-        }
-        *jsonString = loadDefaults();
-        return false;
-    }
-
-    *jsonString = file.readString();
-    file.close();
-
+    *jsonString = _fsProvider->readFile(filename);
     if (jsonString->isEmpty())
     {
         if (verbose)
         {
-            LOG_WARN(LOG_CAT_CONFIG, "Config file empty.");
+            LOG_WARN(LOG_CAT_CONFIG, "Config file missing or empty. Falling back to defaults.");
         }
         *jsonString = loadDefaults();
         return false;
@@ -380,11 +486,6 @@ bool configManager::loadConfigString(const char *filename, String *jsonString, b
     return true;
 }
 
-bool configManager::jsonStringToConfig(const String &jsonString, bool verbose)
-{
-    return jsonStringToMap(jsonString, _configMap, verbose);
-}
-
 bool configManager::jsonStringToMap(const String &jsonString, std::map<String, std::map<String, String>> &configMap, bool verbose)
 {
     configMap.clear();
@@ -479,40 +580,52 @@ bool configManager::jsonStringToMap(const String &jsonString, std::map<String, s
 
 bool configManager::saveToJson(const String &path, const std::map<String, std::map<String, String>> &configMap) const
 {
-    String jsonOutput = mapToJsonString(configMap);
+    size_t written = 0;
+    {
+        // Also taken by the async worker: another task's session cannot unmount under this write
+        fileSystemSession session(_fsProvider);
+        if (!session.isMounted())
+        {
+            LOG_ERROR(LOG_CAT_CONFIG, "Failed to mount filesystem for writing: %s", path.c_str());
+            return false;
+        }
+        written = writeJson(path, configMap);
+    }
 
-    // Ensure filesystem is mounted (begin() is idempotent with static flag in littleFSProvider)
-    if (!_fsProvider || !_fsProvider->begin())
+    if (written == 0)
     {
-        LOG_ERROR(LOG_CAT_CONFIG, "Failed to mount filesystem for writing: %s", path.c_str());
         return false;
     }
 
-    fs::File file = _fsProvider->open(path.c_str(), "w");
-    if (!file)
+    // MANDATORY: Always track flash writes for device lifecycle management
+    if (!updateFlashWearCounter(written, _fsProvider->blockSize()))
     {
-        LOG_ERROR(LOG_CAT_CONFIG, "Failed to open file for writing: %s", path.c_str());
-        _fsProvider->end();
-        return false;
+        LOG_WARN(LOG_CAT_CONFIG, "Flash wear counter update failed after saving %s", path.c_str());
     }
 
-    size_t written = file.print(jsonOutput);
-    file.close();
-    _fsProvider->end();
+    return true;
+}
+
+size_t configManager::writeJson(const String &path, const std::map<String, std::map<String, String>> &configMap) const
+{
+    // Filesystem mounted by the caller, who also owns the wear counter update
+    String jsonOutput;
+    {
+        // Async jobs pass their own snapshot, which needs no lock
+        configSharedGuard guard(&configMap == &_configMap ? _lock : nullptr);
+        jsonOutput = mapToJsonString(configMap);
+    }
 
+    const size_t written = _fsProvider->writeFile(path.c_str(), jsonOutput);
     if (written == 0)
     {
-        LOG_WARN(LOG_CAT_CONFIG, "Nothing was written to %s", path.c_str());
-        return false;
+        LOG_ERROR(LOG_CAT_CONFIG, "Failed to write config file: %s", path.c_str());
+        return 0;
     }
 
     LOG_INFO(LOG_CAT_CONFIG, "Config saved to %s (%u bytes)", path.c_str(), static_cast<unsigned int>(written));
-
-    // MANDATORY: Always track flash writes for device lifecycle management
-    const bool wearResult = updateFlashWearCounter();
-    LOG_INFO(LOG_CAT_CONFIG, "updateFlashWearCounter() returned: %s", wearResult ? "true" : "false");
-
-    return true;
+    attributeFlashWrite(_domainName.c_str(), path.c_str(), written, _fsProvider->blockSize());
+    return written;
 }
 
 bool configManager::saveConfigFile(const char *filename)
@@ -522,6 +635,11 @@ bool configManager::saveConfigFile(const char *filename)
 
 String configManager::getValue(const String &section, const String &key) const
 {
+    if (_snapshotsEnabled)
+    {
+        return getView()->getValue(section, key);
+    }
+    configSharedGuard guard(_lock);
     auto sectionIt = _configMap.find(section);
     if (sectionIt == _configMap.end())
     {
@@ -539,7 +657,29 @@ String configManager::getValue(const String &section, const String &key) const
 
 void configManager::setValue(const String &section, const String &key, const String &value)
 {
-    _configMap[section][key] = value;
+    std::vector<notification> notifications;
+    {
+        configExclusiveGuard guard(_lock);
+        std::map<String, String> &fields = _configMap[section];
+        auto it = fields.find(key);
+        const bool changed = it == fields.end() || it->second != value;
+        if (it == fields.end())
+        {
+            fields.emplace(key, value);
+        }
+        else
+        {
+            it->second = value;
+        }
+        _dirtySections.insert(section);
+        publishView(&section);
+        if (changed)
+        {
+            bumpVersion(section);
+            queueNotifications(section, key, notifications);
+        }
+    }
+    dispatchNotifications(notifications);
 }
 
 const std::map<String, std::map<String, String>> &configManager::getConfig() const
@@ -558,6 +698,12 @@ String configManager::getPassword() const
 }
 
 void configManager::printConfigToSerial() const
+{
+    configSharedGuard guard(_lock);
+    printConfigMap();
+}
+
+void configManager::printConfigMap() const
 {
     LOG_INFO(LOG_CAT_CONFIG, "\n===== Configuration Map =====");
     for (const auto &section : _configMap)
@@ -618,18 +764,161 @@ String configManager::mapToJsonString(const std::map<String, std::map<String, St
 #endif
 }
 
+size_t configManager::exportJson(Print &out) const
+{
+    return exportSections(out, nullptr);
+}
+
+size_t configManager::exportJson(Print &out, const String &section) const
+{
+    const std::vector<String> sections(1, section);
+    return exportSections(out, &sections);
+}
+
+size_t configManager::exportJson(Print &out, const std::vector<String> &sections) const
+{
+    return exportSections(out, &sections);
+}
+
+size_t configManager::exportSections(Print &out, const std::vector<String> *sections) const
+{
+    configJsonWriter writer(out);
+    bool first = true;
+    writer.raw('{');
+    if (_snapshotsEnabled)
+    {
+        // The held view stays consistent however slow the sink is
+        const configViewPtr view = getView();
+        if (sections)
+        {
+            for (const auto &name : *sections)
+            {
+                auto it = view->_sections.find(name);
+                if (it != view->_sections.end() && !writer.isFailed())
+                {
+                    exportSection(writer, name, *it->second, first);
+                }
+            }
+        }
+        else
+        {
+            for (const auto &entry : view->_sections)
+            {
+                if (writer.isFailed())
+                {
+                    break;
+                }
+                exportSection(writer, entry.first, *entry.second, first);
+            }
+        }
+    }
+    else
+    {
+        // One section copied at a time under the lock, streamed after releasing it,
+        // so a stalled sink never holds off writers
+        std::map<String, String> fields;
+        if (sections)
+        {
+            for (const auto &name : *sections)
+            {
+                if (writer.isFailed())
+                {
+                    break;
+                }
+                bool found;
+                {
+                    configSharedGuard guard(_lock);
+                    auto it = _configMap.find(name);
+                    found = it != _configMap.end();
+                    if (found)
+                    {
+                        fields = it->second;
+                    }
+                }
+                if (found)
+                {
+                    exportSection(writer, name, fields, first);
+                }
+            }
+        }
+        else
+        {
+            String name;
+            for (bool more = true; more && !writer.isFailed();)
+            {
+                {
+                    // Resume after the last section streamed; the map may have changed meanwhile
+                    configSharedGuard guard(_lock);
+                    auto it = first ? _configMap.begin() : _configMap.upper_bound(name);
+                    more = it != _configMap.end();
+                    if (more)
+                    {
+                        name = it->first;
+                        fields = it->second;
+                    }
+                }
+                if (more)
+                {
+                    exportSection(writer, name, fields, first);
+                }
+            }
+        }
+    }
+    writer.raw('}');
+    return writer.flush();
+}
+
+void configManager::exportSection(configJsonWriter &writer, const String &name, const std::map<String, String> &fields, bool &first)
+{
+    if (!first)
+    {
+        writer.raw(',');
+    }
+    first = false;
+    writer.string(name);
+    writer.raw(":{");
+    bool firstKey = true;
+    for (const auto &kv : fields)
+    {
+        if (!firstKey)
+        {
+            writer.raw(',');
+        }
+        firstKey = false;
+        writer.string(kv.first);
+        writer.raw(':');
+        writer.string(kv.second);
+    }
+    writer.raw('}');
+}
+
 std::map<String, String> &configManager::getSection(const String &sectionName)
 {
+    // Caller may modify the section through the reference
+    configExclusiveGuard guard(_lock);
+    _dirtySections.insert(sectionName);
     return _configMap[sectionName];
 }
 
 const std::map<String, String> &configManager::getSection(const String &sectionName) const
 {
     static const std::map<String, String> EMPTY_SECTION;
+    configSharedGuard guard(_lock);
     auto it = _configMap.find(sectionName);
     return it != _configMap.end() ? it->second : EMPTY_SECTION;
 }
 
+std::map<String, String> configManager::getSectionCopy(const String &sectionName) const
+{
+    if (_snapshotsEnabled)
+    {
+        return getView()->getSection(sectionName);
+    }
+    configSharedGuard guard(_lock);
+    auto it = _configMap.find(sectionName);
+    return it != _configMap.end() ? it->second : std::map<String, String>();
+}
+
 bool configManager::parseHexStringToBytes(const String &hexInput, uint8_t *outputBuffer, size_t bufferLen) const
 {
     if (!outputBuffer || bufferLen == 0)
@@ -667,7 +956,12 @@ bool configManager::parseHexStringToBytes(const String &hexInput, uint8_t *outpu
 
 std::vector<String> configManager::getSections() const
 {
+    if (_snapshotsEnabled)
+    {
+        return getView()->getSections();
+    }
     std::vector<String> sections;
+    configSharedGuard guard(_lock);
     sections.reserve(_configMap.size());
     for (const auto &section : _configMap)
     {
@@ -679,6 +973,7 @@ std::vector<String> configManager::getSections() const
 std::vector<String> configManager::getFormatSections() const
 {
     std::vector<String> formatSections;
+    configSharedGuard guard(_lock);
     formatSections.reserve(_configMap.size());
     for (const auto &section : _configMap)
     {
@@ -694,7 +989,12 @@ std::vector<String> configManager::getFormatSections() const
 
 std::vector<String> configManager::getKeys(const String &section) const
 {
+    if (_snapshotsEnabled)
+    {
+        return getView()->getKeys(section);
+    }
     std::vector<String> keys;
+    configSharedGuard guard(_lock);
     auto sectionIt = _configMap.find(section);
     if (sectionIt == _configMap.end())
     {
@@ -711,98 +1011,1112 @@ std::vector<String> configManager::getKeys(const String &section) const
 
 bool configManager::saveConfig()
 {
-    return saveConfigFile(_configFilePath.c_str());
+    if (_writeGovernor && !_writeGovernor->tryAcquire())
+    {
+        deferSave();
+        return true;
+    }
+    return saveNow();
 }
 
-bool configManager::loadConfig()
+void configManager::deferSave()
 {
-    return begin(_configFilePath.c_str(), true);
+    // Over budget: keep the changes in RAM, serviceDeferredSave() writes them later
+    _savesDeferred++;
+    if (_saveDeferred)
+    {
+        _savesCoalesced++;
+    }
+    _saveDeferred = true;
+    LOG_DEBUG(LOG_CAT_CONFIG, "Save of %s deferred by write budget (%.1f/h)",
+              _configFilePath.c_str(), _writeGovernor->getCurrentBudget());
 }
 
-void configManager::printHeapStatus() const
+bool configManager::hasUnsavedChanges() const
 {
-#if defined(ESP8266) || defined(ESP32)
-    LOG_INFO(LOG_CAT_CONFIG, "[configManager] Free heap: %u bytes", ESP.getFreeHeap());
-    LOG_INFO(LOG_CAT_CONFIG, "[configManager] Config memory usage: %u bytes", static_cast<unsigned int>(getConfigMemoryUsage()));
-#endif
+    configSharedGuard guard(_lock);
+    return _saveDeferred || !_dirtySections.empty();
 }
 
-size_t configManager::getConfigMemoryUsage() const
+bool configManager::writeDirty(size_t &written)
 {
-    size_t total = 0;
-    for (const auto &section : _configMap)
+    // Filesystem mounted by the caller, who also owns the wear counter update
+    const std::set<String> saving = takeDirtySections();
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
     {
-        total += section.first.length();
-        for (const auto &kv : section.second)
+        std::map<String, std::map<String, String>> dirty;
+        std::vector<String> manifest;
+        const bool manifestChanged = collectShardChanges(saving, dirty, manifest);
+        if (dirty.empty() && !manifestChanged)
         {
-            total += kv.first.length();
-            total += kv.second.length();
+            _saveDeferred = false;
+            return true;
+        }
+        if (!writeShards(dirty, manifestChanged ? &manifest : nullptr, written))
+        {
+            restoreDirtySections(saving);
+            return false;
         }
+        commitShardChanges(manifest);
     }
-    return total;
+    else
+    {
+        const size_t bytes = writeJson(_configFilePath, _configMap);
+        if (bytes == 0)
+        {
+            restoreDirtySections(saving);
+            return false;
+        }
+        written += bytes;
+    }
+    _saveDeferred = false;
+    return true;
 }
 
-bool configManager::clearConfig()
+bool configManager::saveAllDirty()
 {
-    bool removed = _fsProvider ? _fsProvider->remove(_configFilePath.c_str()) : false;
-    _configMap.clear();
-    return removed;
-}
+    const unsigned long start = millis();
+    std::vector<configManager*> pending;
+    for (configManager *config : domainRegistry::getAll())
+    {
+        config->waitForAsyncSave();
+        if (!config->hasUnsavedChanges())
+        {
+            continue;
+        }
+        if (config->_writeGovernor && !config->_writeGovernor->tryAcquire())
+        {
+            config->deferSave();
+            continue;
+        }
+        pending.push_back(config);
+    }
 
-configManager::~configManager() {
-    // Unregister from domain registry if registered
-    if (_domainName.length() > 0) {
-        auto it = _domainRegistry.find(_domainName);
-        if (it != _domainRegistry.end() && it->second == this) {
-            _domainRegistry.erase(it);
+    // Domains sharing a filesystem are written in one mount session with one wear update
+    std::stable_sort(pending.begin(), pending.end(), [](const configManager *a, const configManager *b) {
+        return std::less<iFileSystemProvider*>()(a->_fsProvider, b->_fsProvider);
+    });
+    bool ok = true;
+    size_t saved = 0;
+    size_t totalWritten = 0;
+    for (size_t first = 0; first < pending.size();)
+    {
+        iFileSystemProvider *fs = pending[first]->_fsProvider;
+        size_t last = first;
+        while (last < pending.size() && pending[last]->_fsProvider == fs)
+        {
+            last++;
+        }
+
+        size_t written = 0;
+        {
+            fileSystemSession session(fs);
+            if (!session.isMounted())
+            {
+                LOG_ERROR(LOG_CAT_CONFIG, "Failed to mount filesystem for %u domain(s)", static_cast<unsigned int>(last - first));
+                ok = false;
+                first = last;
+                continue;
+            }
+            for (size_t i = first; i < last; i++)
+            {
+                if (pending[i]->writeDirty(written))
+                {
+                    saved++;
+                }
+                else
+                {
+                    ok = false;
+                }
+            }
         }
-        if (_defaultDomain == this) {
-            _defaultDomain = nullptr;
+
+        if (written > 0 && !updateFlashWearCounter(written, fs->blockSize()))
+        {
+            LOG_WARN(LOG_CAT_CONFIG, "Flash wear counter update failed after batched save");
         }
+        totalWritten += written;
+        first = last;
+    }
+
+    if (!pending.empty())
+    {
+        LOG_INFO(LOG_CAT_CONFIG, "Saved %u of %u dirty domain(s) (%u bytes) in %lu ms",
+                 static_cast<unsigned int>(saved), static_cast<unsigned int>(pending.size()),
+                 static_cast<unsigned int>(totalWritten), millis() - start);
     }
+    return ok;
 }
 
-void configManager::setDomain(const String& domainName, bool isDefault) {
-    // Unregister old domain if changing
-    if (_domainName.length() > 0 && _domainName != domainName) {
-        auto it = _domainRegistry.find(_domainName);
-        if (it != _domainRegistry.end() && it->second == this) {
-            _domainRegistry.erase(it);
+bool configManager::loadAll(std::vector<domainLoadTiming> *timings)
+{
+    const unsigned long start = micros();
+    std::vector<storedConfig> loads;
+    for (configManager *config : domainRegistry::getAll())
+    {
+        config->waitForAsyncSave();
+        loads.emplace_back();
+        loads.back().owner = config;
+    }
+
+    // Flash reads stay on this task: providers are not thread-safe and the
+    // flash is one bus anyway. Each filesystem is mounted once.
+    std::vector<size_t> order(loads.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&loads](size_t a, size_t b) {
+        return std::less<iFileSystemProvider*>()(loads[a].owner->_fsProvider, loads[b].owner->_fsProvider);
+    });
+    for (size_t first = 0; first < order.size();)
+    {
+        iFileSystemProvider *fs = loads[order[first]].owner->_fsProvider;
+        size_t last = first;
+        while (last < order.size() && loads[order[last]].owner->_fsProvider == fs)
+        {
+            last++;
         }
-        if (_defaultDomain == this) {
-            _defaultDomain = nullptr;
+
+        fileSystemSession session(fs);
+        if (!session.isMounted())
+        {
+            LOG_ERROR(LOG_CAT_CONFIG, "Failed to mount filesystem for %u domain(s), loading defaults", static_cast<unsigned int>(last - first));
+        }
+        for (size_t i = first; i < last; i++)
+        {
+            storedConfig &stored = loads[order[i]];
+            const unsigned long readStart = micros();
+            if (session.isMounted())
+            {
+                stored.owner->readStored(stored, false);
+            }
+            else
+            {
+                stored.json = stored.owner->loadDefaults();
+            }
+            stored.readMicros = micros() - readStart;
         }
+        first = last;
     }
-    
-    _domainName = domainName;
-    _isDefaultDomain = isDefault;
-    
-    // Register in static registry
-    if (domainName.length() > 0) {
-        _domainRegistry[domainName] = this;
-        if (isDefault || _defaultDomain == nullptr) {
-            _defaultDomain = this;
+
+    const unsigned long parseStart = micros();
+    parallelRunner::run(loads.size(), parseStoredJob, &loads);
+    const unsigned long parseWall = micros() - parseStart;
+
+    bool ok = true;
+    unsigned long parseTotal = 0;
+    if (timings)
+    {
+        timings->clear();
+    }
+    for (storedConfig &stored : loads)
+    {
+        configManager *config = stored.owner;
+        domainLoadTiming timing;
+        timing.domain = config->_domainName;
+        timing.bytes = stored.bytes;
+        timing.readMicros = stored.readMicros;
+        timing.parseMicros = stored.parseMicros;
+
+        std::vector<notification> notifications;
+        timing.loaded = config->installStored(stored, false, &notifications);
+        config->dispatchNotifications(notifications);
+        ok = ok && timing.loaded;
+        parseTotal += timing.parseMicros;
+
+        LOG_INFO(LOG_CAT_CONFIG, "Loaded domain %s: %u bytes, read %lu us, parse %lu us",
+                 timing.domain.c_str(), static_cast<unsigned int>(timing.bytes), timing.readMicros, timing.parseMicros);
+        if (timings)
+        {
+            timings->push_back(timing);
         }
     }
+
+    if (!loads.empty())
+    {
+        LOG_INFO(LOG_CAT_CONFIG, "Loaded %u domain(s) in %lu us; parsing took %lu us on %u core(s) for %lu us of work",
+                 static_cast<unsigned int>(loads.size()), micros() - start, parseWall,
+                 static_cast<unsigned int>(parallelRunner::getWorkerCount(loads.size())), parseTotal);
+    }
+    return ok;
 }
 
-std::vector<String> configManager::getDomainNames() {
-    std::vector<String> names;
-    names.reserve(_domainRegistry.size());
-    for (const auto& pair : _domainRegistry) {
-        names.push_back(pair.first);
+void configManager::parseStoredJob(size_t index, void *context)
+{
+    storedConfig &stored = (*static_cast<std::vector<storedConfig> *>(context))[index];
+    const unsigned long parseStart = micros();
+    stored.owner->parseStored(stored, false);
+    stored.parseMicros = micros() - parseStart;
+}
+
+bool configManager::serviceDeferredSave()
+{
+    if (!_saveDeferred)
+    {
+        return true;
+    }
+    if (_writeGovernor && !_writeGovernor->tryAcquire())
+    {
+        return true;
+    }
+    return saveNow();
+}
+
+bool configManager::flushConfig()
+{
+    return saveNow();
+}
+
+bool configManager::saveNow()
+{
+    // A queued async snapshot is older than the current map; let it land first
+    waitForAsyncSave();
+
+    const std::set<String> saving = takeDirtySections();
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+    {
+        std::map<String, std::map<String, String>> dirty;
+        std::vector<String> manifest;
+        const bool manifestChanged = collectShardChanges(saving, dirty, manifest);
+        if (dirty.empty() && !manifestChanged)
+        {
+            _saveDeferred = false;
+            return true;
+        }
+        if (!saveShards(dirty, manifestChanged ? &manifest : nullptr))
+        {
+            restoreDirtySections(saving);
+            return false;
+        }
+        commitShardChanges(manifest);
+        _saveDeferred = false;
+        return true;
     }
-    return names;
+
+    if (!saveConfigFile(_configFilePath.c_str()))
+    {
+        restoreDirtySections(saving);
+        return false;
+    }
+    _saveDeferred = false;
+    return true;
+}
+
+bool configManager::saveConfigAsync(asyncSaveCallback callback, void *context)
+{
+    // Same budget as saveConfig(): over it, nothing is queued and serviceDeferredSave() writes later
+    if (_writeGovernor && !_writeGovernor->tryAcquire())
+    {
+        deferSave();
+        return true;
+    }
+
+    // The worker hands the sections back (finishAsyncSave()) unless they reach the flash
+    std::set<String> saving = takeDirtySections();
+    if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+    {
+        asyncSaveWorker::configSnapshot dirty;
+        std::vector<String> manifest;
+        const bool manifestChanged = collectShardChanges(saving, dirty, manifest);
+        const std::set<String> taken = saving;
+        if (!asyncSaveWorker::instance().submitShards(this, std::move(dirty), std::move(saving), manifestChanged, manifest,
+                                                      callback, context))
+        {
+            restoreDirtySections(taken);
+            return false;
+        }
+        _saveDeferred = false;
+        return true;
+    }
+
+    asyncSaveWorker::configSnapshot snapshot;
+    {
+        configSharedGuard guard(_lock);
+        snapshot = _configMap;
+    }
+    const std::set<String> taken = saving;
+    if (!asyncSaveWorker::instance().submit(this, _configFilePath, std::move(snapshot), std::move(saving), callback, context))
+    {
+        restoreDirtySections(taken);
+        return false;
+    }
+    // The queued job covers the deferred changes; a failure marks them dirty again
+    _saveDeferred = false;
+    return true;
+}
+
+void configManager::finishAsyncSave(bool saved, const std::set<String> &sections, const std::vector<String> *manifest)
+{
+    if (!saved)
+    {
+        restoreDirtySections(sections);
+        return;
+    }
+    if (manifest)
+    {
+        commitShardChanges(*manifest);
+    }
+}
+
+std::set<String> configManager::takeDirtySections()
+{
+    // Taken before the save reads the map: a section changed meanwhile is dirty again afterwards
+    std::set<String> taken;
+    configExclusiveGuard guard(_lock);
+    taken.swap(_dirtySections);
+    return taken;
+}
+
+void configManager::restoreDirtySections(const std::set<String> &sections)
+{
+    configExclusiveGuard guard(_lock);
+    _dirtySections.insert(sections.begin(), sections.end());
+}
+
+void configManager::setStorageLayout(configStorageLayout layout, const String &shardDirectory)
+{
+    waitForAsyncSave();
+    _storageLayout = layout;
+    _shardDirectory = shardDirectory;
+    if (_shardDirectory.isEmpty())
+    {
+        // "/config.json" -> "/config.d"
+        _shardDirectory = _configFilePath;
+        if (_shardDirectory.endsWith(".json"))
+        {
+            _shardDirectory.remove(_shardDirectory.length() - 5);
+        }
+        _shardDirectory += ".d";
+    }
+    while (_shardDirectory.length() > 1 && _shardDirectory.endsWith("/"))
+    {
+        _shardDirectory.remove(_shardDirectory.length() - 1);
+    }
+
+    // Nothing is known to be on flash in the new layout yet
+    configExclusiveGuard guard(_lock);
+    _shardSections.clear();
+    for (const auto &section : _configMap)
+    {
+        _dirtySections.insert(section.first);
+    }
+}
+
+String configManager::getShardPath(const String &section) const
+{
+    // Keep names portable across LittleFS/SPIFFS; a hash suffix keeps
+    // sanitized names that would otherwise collide apart
+    String name;
+    bool changed = section.isEmpty();
+    for (size_t i = 0; i < section.length(); i++)
+    {
+        const char c = section[i];
+        if (isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '-')
+        {
+            name += c;
+        }
+        else
+        {
+            name += '_';
+            changed = true;
+        }
+    }
+    if (changed)
+    {
+        uint16_t hash = 0x811C;
+        for (size_t i = 0; i < section.length(); i++)
+        {
+            hash = static_cast<uint16_t>((hash ^ static_cast<uint8_t>(section[i])) * 0x0193);
+        }
+        char suffix[6];
+        snprintf(suffix, sizeof(suffix), "~%04x", hash);
+        name += suffix;
+    }
+    return _shardDirectory + "/" + name + ".json";
+}
+
+String configManager::getShardManifestPath() const
+{
+    // Shard names never start with '~', so no section can map onto the manifest
+    return _shardDirectory + "/~manifest.json";
+}
+
+bool configManager::collectShardChanges(const std::set<String> &sections, std::map<String, std::map<String, String>> &dirty, std::vector<String> &manifest) const
+{
+    configSharedGuard guard(_lock);
+    for (const auto &section : sections)
+    {
+        auto it = _configMap.find(section);
+        if (it != _configMap.end())
+        {
+            dirty.emplace(it->first, it->second);
+        }
+    }
+
+    bool changed = _shardSections.size() != _configMap.size();
+    manifest.reserve(_configMap.size());
+    for (const auto &section : _configMap)
+    {
+        manifest.push_back(section.first);
+        if (!changed && _shardSections.find(section.first) == _shardSections.end())
+        {
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void configManager::commitShardChanges(const std::vector<String> &manifest)
+{
+    configExclusiveGuard guard(_lock);
+    _shardSections.clear();
+    _shardSections.insert(manifest.begin(), manifest.end());
+}
+
+bool configManager::saveShards(const std::map<String, std::map<String, String>> &sections, const std::vector<String> *manifest) const
+{
+    size_t totalWritten = 0;
+    bool ok;
+    {
+        fileSystemSession session(_fsProvider);
+        if (!session.isMounted())
+        {
+            LOG_ERROR(LOG_CAT_CONFIG, "Failed to mount filesystem for writing: %s", _shardDirectory.c_str());
+            return false;
+        }
+        ok = writeShards(sections, manifest, totalWritten);
+    }
+
+    if (totalWritten > 0)
+    {
+        // One wear update per save session, however many shards it touched
+        updateFlashWearCounter(totalWritten, _fsProvider->blockSize());
+    }
+    return ok;
+}
+
+bool configManager::writeShards(const std::map<String, std::map<String, String>> &sections, const std::vector<String> *manifest,
+                                size_t &totalWritten) const
+{
+    // Filesystem mounted by the caller, who also owns the wear counter update
+    const size_t startBytes = totalWritten;
+    // Result ignored: flat filesystems (SPIFFS) refuse mkdir but accept "/dir/file" names
+    _fsProvider->mkdir(_shardDirectory.c_str());
+
+    bool ok = true;
+    std::map<String, std::map<String, String>> shard;
+    for (const auto &section : sections)
+    {
+        shard.clear();
+        shard.emplace(section.first, section.second);
+        const String path = getShardPath(section.first);
+        const size_t written = _fsProvider->writeFile(path.c_str(), mapToJsonString(shard));
+        if (written == 0)
+        {
+            LOG_ERROR(LOG_CAT_CONFIG, "Failed to write config shard: %s", path.c_str());
+            ok = false;
+        }
+        else
+        {
+            attributeFlashWrite(_domainName.c_str(), path.c_str(), written, _fsProvider->blockSize());
+        }
+        totalWritten += written;
+    }
+
+    if (ok && manifest)
+    {
+        std::map<String, std::map<String, String>> manifestMap;
+        std::map<String, String> &files = manifestMap["manifest"];
+        for (const auto &section : *manifest)
+        {
+            files.emplace(section, getShardPath(section));
+        }
+        const String path = getShardManifestPath();
+        const size_t written = _fsProvider->writeFile(path.c_str(), mapToJsonString(manifestMap));
+        if (written == 0)
+        {
+            LOG_ERROR(LOG_CAT_CONFIG, "Failed to write shard manifest: %s", path.c_str());
+            ok = false;
+        }
+        else
+        {
+            attributeFlashWrite(_domainName.c_str(), path.c_str(), written, _fsProvider->blockSize());
+            // Only once the new manifest is down: shards of removed sections would be orphaned otherwise
+            std::vector<String> removed;
+            {
+                configSharedGuard guard(_lock);
+                for (const auto &section : _shardSections)
+                {
+                    if (std::find(manifest->begin(), manifest->end(), section) == manifest->end())
+                    {
+                        removed.push_back(section);
+                    }
+                }
+            }
+            for (const auto &section : removed)
+            {
+                _fsProvider->remove(getShardPath(section).c_str());
+            }
+        }
+        totalWritten += written;
+    }
+
+    LOG_INFO(LOG_CAT_CONFIG, "Saved %u config shard(s)%s to %s (%u bytes)",
+             static_cast<unsigned int>(sections.size()), manifest ? " + manifest" : "",
+             _shardDirectory.c_str(), static_cast<unsigned int>(totalWritten - startBytes));
+    return ok;
+}
+
+bool configManager::loadSection(const String &section)
+{
+    waitForAsyncSave();
+    String json;
+    {
+        fileSystemSession session(_fsProvider);
+        if (!session.isMounted())
+        {
+            return false;
+        }
+        if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+        {
+            json = _fsProvider->readFile(getShardPath(section).c_str());
+        }
+        else
+        {
+            json = _fsProvider->readFile(_configFilePath.c_str());
+        }
+    }
+
+    std::map<String, std::map<String, String>> parsed;
+    if (json.isEmpty() || !jsonStringToMap(json, parsed, false))
+    {
+        return false;
+    }
+    auto it = parsed.find(section);
+    if (it == parsed.end())
+    {
+        return false;
+    }
+    std::vector<notification> notifications;
+    {
+        configExclusiveGuard guard(_lock);
+        std::map<String, std::map<String, String>> before;
+        auto current = _configMap.find(section);
+        before[section] = (current != _configMap.end()) ? std::move(current->second) : std::map<String, String>();
+        _configMap[section] = std::move(it->second);
+        _dirtySections.erase(section);
+        publishView(&section);
+        bumpVersion(diffSections(before, false, notifications));
+    }
+    dispatchNotifications(notifications);
+    return true;
+}
+
+bool configManager::loadConfig()
+{
+    waitForAsyncSave();
+    std::vector<notification> notifications;
+    const bool loaded = begin(_configFilePath.c_str(), true, &notifications);
+    dispatchNotifications(notifications);
+    return loaded;
+}
+
+void configManager::printHeapStatus() const
+{
+#if defined(ESP8266) || defined(ESP32)
+    LOG_INFO(LOG_CAT_CONFIG, "[configManager] Free heap: %u bytes", ESP.getFreeHeap());
+    LOG_INFO(LOG_CAT_CONFIG, "[configManager] Config memory usage: %u bytes", static_cast<unsigned int>(getConfigMemoryUsage()));
+#endif
+}
+
+size_t configManager::getConfigMemoryUsage() const
+{
+    size_t total = 0;
+    configSharedGuard guard(_lock);
+    for (const auto &section : _configMap)
+    {
+        total += section.first.length();
+        for (const auto &kv : section.second)
+        {
+            total += kv.first.length();
+            total += kv.second.length();
+        }
+    }
+    return total;
+}
+
+bool configManager::clearConfig()
+{
+    waitForAsyncSave();
+    bool removed = false;
+    {
+        fileSystemSession session(_fsProvider);
+        if (session.isMounted())
+        {
+            removed = _fsProvider->remove(_configFilePath.c_str());
+            if (_storageLayout == CONFIG_LAYOUT_SHARDED)
+            {
+                for (const auto &section : _shardSections)
+                {
+                    removed = _fsProvider->remove(getShardPath(section).c_str()) || removed;
+                }
+                removed = _fsProvider->remove(getShardManifestPath().c_str()) || removed;
+            }
+        }
+    }
+    std::vector<notification> notifications;
+    {
+        configExclusiveGuard guard(_lock);
+        std::map<String, std::map<String, String>> before;
+        before.swap(_configMap);
+        _dirtySections.clear();
+        _shardSections.clear();
+        publishView(nullptr);
+        bumpVersion(diffSections(before, false, notifications));
+    }
+    dispatchNotifications(notifications);
+    return removed;
+}
+
+void configManager::enableConcurrency()
+{
+    if (!_lock)
+    {
+        _lock = new configLock();
+    }
+}
+
+void configManager::enableSnapshots()
+{
+    configExclusiveGuard guard(_lock);
+    _snapshotsEnabled = true;
+    publishView(nullptr);
+}
+
+configViewPtr configManager::getView() const
+{
+    if (_snapshotsEnabled)
+    {
+        // Never waits for the config lock or a map rebuild; libstdc++ still takes a brief internal mutex here
+        return std::atomic_load(&_view);
+    }
+    configSharedGuard guard(_lock);
+    return buildView();
+}
+
+void configManager::publishView()
+{
+    configExclusiveGuard guard(_lock);
+    publishView(nullptr);
+}
+
+std::shared_ptr<configView> configManager::buildView() const
+{
+    std::shared_ptr<configView> view = std::make_shared<configView>();
+    for (const auto &section : _configMap)
+    {
+        view->_sections.emplace(section.first, std::make_shared<const configView::section>(section.second));
+    }
+    view->_version = _viewVersion;
+    return view;
+}
+
+void configManager::publishView(const String *changedSection)
+{
+    // Caller holds the exclusive lock (or is the only task)
+    if (!_snapshotsEnabled)
+    {
+        return;
+    }
+
+    std::shared_ptr<configView> next;
+    const configViewPtr current = std::atomic_load(&_view);
+    if (changedSection && current)
+    {
+        // Copy the index, share every section but the changed one
+        next = std::make_shared<configView>(*current);
+        refreshViewSection(*next, *changedSection);
+    }
+    else
+    {
+        next = buildView();
+    }
+    storeView(next);
+}
+
+void configManager::publishView(const std::set<String> &changedSections)
+{
+    if (!_snapshotsEnabled)
+    {
+        return;
+    }
+
+    const configViewPtr current = std::atomic_load(&_view);
+    if (!current)
+    {
+        publishView(nullptr);
+        return;
+    }
+    std::shared_ptr<configView> next = std::make_shared<configView>(*current);
+    for (const auto &section : changedSections)
+    {
+        refreshViewSection(*next, section);
+    }
+    storeView(next);
+}
+
+void configManager::refreshViewSection(configView &view, const String &section) const
+{
+    auto it = _configMap.find(section);
+    if (it != _configMap.end())
+    {
+        view._sections[section] = std::make_shared<const configView::section>(it->second);
+    }
+    else
+    {
+        view._sections.erase(section);
+    }
+}
+
+void configManager::storeView(std::shared_ptr<configView> &next)
+{
+    next->_version = ++_viewVersion;
+    // Readers holding the old version keep it alive; the last one frees it
+    std::atomic_store(&_view, configViewPtr(std::move(next)));
+}
+
+void configManager::applyTransaction(const std::vector<configOperation> &operations)
+{
+    std::vector<notification> notifications;
+    {
+        configExclusiveGuard guard(_lock);
+        // Old contents of every touched section, compared once the whole batch is in
+        std::map<String, std::map<String, String>> before;
+        for (const auto &op : operations)
+        {
+            if (before.find(op.section) == before.end())
+            {
+                auto current = _configMap.find(op.section);
+                before[op.section] = (current != _configMap.end()) ? current->second : std::map<String, String>();
+            }
+        }
+        applyOperations(operations);
+        bumpVersion(diffSections(before, false, notifications));
+    }
+    dispatchNotifications(notifications);
+}
+
+void configManager::applyOperations(const std::vector<configOperation> &operations)
+{
+    // Caller holds the exclusive lock
+    std::set<String> changed;
+    for (const auto &op : operations)
+    {
+        switch (op.type)
+        {
+        case CONFIG_OP_SET:
+            _configMap[op.section][op.key] = op.value;
+            break;
+        case CONFIG_OP_REMOVE_KEY:
+        {
+            auto it = _configMap.find(op.section);
+            if (it == _configMap.end() || it->second.erase(op.key) == 0)
+            {
+                continue;
+            }
+            break;
+        }
+        case CONFIG_OP_REMOVE_SECTION:
+            if (_configMap.erase(op.section) == 0)
+            {
+                continue;
+            }
+            break;
+        }
+        changed.insert(op.section);
+    }
+    if (changed.empty())
+    {
+        return;
+    }
+    _dirtySections.insert(changed.begin(), changed.end());
+    publishView(changed);
+}
+
+uint16_t configManager::subscribe(const String &section, const String &key, configChangeCallback callback, void *context)
+{
+    return callback ? addSubscription(section, key, callback, context, nullptr) : 0;
+}
+
+uint16_t configManager::subscribe(const String &section, const String &key, configChangeQueue *queue)
+{
+    return queue ? addSubscription(section, key, nullptr, nullptr, queue) : 0;
+}
+
+uint16_t configManager::addSubscription(const String &section, const String &key, configChangeCallback callback,
+                                        void *context, configChangeQueue *queue)
+{
+    configExclusiveGuard guard(_lock);
+    if (_nextSubscriptionId == 0)
+    {
+        // Wrapped after 65535 subscribe() calls; 0 stays the failure value
+        _nextSubscriptionId = 1;
+    }
+    subscription entry;
+    entry.id = _nextSubscriptionId++;
+    entry.section = section;
+    entry.key = key;
+    entry.callback = callback;
+    entry.context = context;
+    entry.queue = queue;
+    _subscriptions.push_back(entry);
+    return entry.id;
+}
+
+bool configManager::unsubscribe(uint16_t id)
+{
+    configExclusiveGuard guard(_lock);
+    for (auto it = _subscriptions.begin(); it != _subscriptions.end(); ++it)
+    {
+        if (it->id == id)
+        {
+            _subscriptions.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void configManager::queueNotifications(const String &section, const String &key, std::vector<notification> &notifications)
+{
+    // Called with the exclusive lock held, which also serializes the queue producers
+    for (const auto &entry : _subscriptions)
+    {
+        if ((!entry.section.isEmpty() && entry.section != section) || (!entry.key.isEmpty() && entry.key != key))
+        {
+            continue;
+        }
+        if (entry.queue)
+        {
+            entry.queue->push({entry.id});
+        }
+        else
+        {
+            notifications.push_back({entry.callback, entry.context, section, key});
+        }
+    }
+}
+
+std::set<String> configManager::diffSections(const std::map<String, std::map<String, String>> &before, bool includeNewSections,
+                                             std::vector<notification> &notifications)
+{
+    static const std::map<String, String> EMPTY_SECTION;
+    std::set<String> sections;
+    for (const auto &section : before)
+    {
+        sections.insert(section.first);
+    }
+    if (includeNewSections)
+    {
+        for (const auto &section : _configMap)
+        {
+            sections.insert(section.first);
+        }
+    }
+
+    std::set<String> changed;
+    for (const auto &name : sections)
+    {
+        auto oldIt = before.find(name);
+        auto newIt = _configMap.find(name);
+        const std::map<String, String> &oldFields = (oldIt != before.end()) ? oldIt->second : EMPTY_SECTION;
+        const std::map<String, String> &newFields = (newIt != _configMap.end()) ? newIt->second : EMPTY_SECTION;
+        // An empty section appearing or going away changes getSections() too
+        bool sectionChanged = (oldIt != before.end()) != (newIt != _configMap.end());
+        for (const auto &field : oldFields)
+        {
+            auto match = newFields.find(field.first);
+            if (match == newFields.end() || match->second != field.second)
+            {
+                queueNotifications(name, field.first, notifications);
+                sectionChanged = true;
+            }
+        }
+        for (const auto &field : newFields)
+        {
+            if (oldFields.find(field.first) == oldFields.end())
+            {
+                queueNotifications(name, field.first, notifications);
+                sectionChanged = true;
+            }
+        }
+        if (sectionChanged)
+        {
+            changed.insert(name);
+        }
+    }
+    return changed;
+}
+
+void configManager::bumpVersion(const String &section)
+{
+    // Caller holds the exclusive lock, so there is one writer at a time
+    const uint32_t version = _changeVersion.load(std::memory_order_relaxed) + 1;
+    _sectionVersions[section] = version;
+    _changeVersion.store(version, std::memory_order_release);
+}
+
+void configManager::bumpVersion(const std::set<String> &sections)
+{
+    if (sections.empty())
+    {
+        return;
+    }
+    const uint32_t version = _changeVersion.load(std::memory_order_relaxed) + 1;
+    for (const auto &section : sections)
+    {
+        _sectionVersions[section] = version;
+    }
+    _changeVersion.store(version, std::memory_order_release);
+}
+
+uint32_t configManager::getSectionVersion(const String &section) const
+{
+    configSharedGuard guard(_lock);
+    auto it = _sectionVersions.find(section);
+    return it != _sectionVersions.end() ? it->second : 0;
+}
+
+String configManager::getETag() const
+{
+    return formatETag(_versionEpoch, getVersion());
+}
+
+String configManager::getETag(const String &section) const
+{
+    return formatETag(_versionEpoch, getSectionVersion(section));
+}
+
+bool configManager::matchesETag(const String &ifNoneMatch) const
+{
+    // Tags are quoted on both ends, so one cannot match inside another; W/ prefixes still match
+    return ifNoneMatch == "*" || ifNoneMatch.indexOf(getETag()) >= 0;
+}
+
+bool configManager::matchesETag(const String &ifNoneMatch, const String &section) const
+{
+    return ifNoneMatch == "*" || ifNoneMatch.indexOf(getETag(section)) >= 0;
+}
+
+void configManager::attachUpdateQueue(configUpdateQueue *queue)
+{
+    if (queue && std::find(_updateQueues.begin(), _updateQueues.end(), queue) == _updateQueues.end())
+    {
+        _updateQueues.push_back(queue);
+    }
+}
+
+void configManager::detachUpdateQueue(configUpdateQueue *queue)
+{
+    _updateQueues.erase(std::remove(_updateQueues.begin(), _updateQueues.end(), queue), _updateQueues.end());
+}
+
+static String formatUpdate(const configUpdate &update)
+{
+    switch (update.type)
+    {
+    case CONFIG_UPDATE_INT:
+        return String(static_cast<long>(update.intValue));
+    case CONFIG_UPDATE_FLOAT:
+        return String(update.floatValue, update.decimals);
+    case CONFIG_UPDATE_TEXT:
+    default:
+        return String(update.text);
+    }
+}
+
+size_t configManager::serviceUpdates(size_t maxUpdates)
+{
+    std::vector<configOperation> operations;
+    configUpdate update;
+    for (configUpdateQueue *queue : _updateQueues)
+    {
+        while (operations.size() < maxUpdates && queue->take(update))
+        {
+            if (update.address >= EEPROMRECORDS)
+            {
+                _updatesRejected++;
+                continue;
+            }
+            // Later posts for the same address simply win inside the transaction
+            const stringTriple &target = addressMap[update.address];
+            operations.push_back({CONFIG_OP_SET, target.section, target.key, formatUpdate(update)});
+        }
+    }
+    if (operations.empty())
+    {
+        return 0;
+    }
+    applyTransaction(operations);
+    _updatesApplied += operations.size();
+    return operations.size();
+}
+
+uint32_t configManager::getUpdateOverflows() const
+{
+    uint32_t overflows = 0;
+    for (const configUpdateQueue *queue : _updateQueues)
+    {
+        overflows += queue->getOverflows();
+    }
+    return overflows;
+}
+
+void configManager::dispatchNotifications(const std::vector<notification> &notifications)
+{
+    // Lock released by now: callbacks may read or even change the config
+    for (const auto &pending : notifications)
+    {
+        pending.callback(this, pending.section, pending.key, pending.context);
+    }
+}
+
+configManager::~configManager() {
+    // Unregister first: lookups on other tasks must not find this config while it is torn down
+    if (_domainName.length() > 0) {
+        domainRegistry::remove(this);
+    }
+    asyncSaveWorker::cancel(this);
+    if (_saveDeferred) {
+        LOG_WARN(LOG_CAT_CONFIG, "Deferred save of %s dropped; call flushConfig() before destruction", _configFilePath.c_str());
+    }
+    // Last: the worker's completion bookkeeping above still takes it
+    delete _lock;
+}
+
+void configManager::setDomain(const String& domainName, bool isDefault) {
+    // Unregister old domain if changing
+    if (_domainName.length() > 0 && _domainName != domainName) {
+        domainRegistry::remove(this);
+    }
+    
+    _domainName = domainName;
+    _isDefaultDomain = isDefault;
+    _domainId = domainRegistry::add(domainName, this, isDefault);
+}
+
+std::vector<String> configManager::getDomainNames() {
+    return domainRegistry::getNames();
 }
 
 configManager* configManager::getDomain(const String& domainName) {
     if (domainName.length() == 0) {
-        return _defaultDomain;
+        return domainRegistry::getDefault();
     }
-    auto it = _domainRegistry.find(domainName);
-    return (it != _domainRegistry.end()) ? it->second : nullptr;
+    return domainRegistry::find(domainName);
 }
 
 configManager* configManager::getDefaultDomain() {
-    return _defaultDomain;
+    return domainRegistry::getDefault();
 }
\ No newline at end of file
@@ -30,8 +30,19 @@
 #include <ArduinoJson.h>
 #include "interface/iFileSystemProvider.hpp" // Use the file system provider interface
 #include "interface/iConfigProvider.hpp" // Use the config provider interface
+#include "asyncSaveWorker.hpp"
+#include "configLock.hpp"
+#include "configView.hpp"
+#include "configTransaction.hpp"
+#include "configChange.hpp"
+#include "configJsonWriter.hpp"
+#include "configUpdateQueue.hpp"
+#include "domainRegistry.hpp"
+#include "writeGovernor.hpp"
 #include <logger.hpp>
+#include <atomic>
 #include <map>
+#include <set>
 #include <vector>
 
 // Debug helper defined in commonFunctions.cpp
@@ -72,12 +83,37 @@ const char* stringAddressName(eePromAddress_t address);
 // ESP8266: Recommended max config size 8KB, test with actual hardware
 // Consider using config sections to load only needed parts on ESP8266
 
+/**
+ * @brief On-flash layout of a configManager's data.
+ *
+ * CONFIG_LAYOUT_SINGLE_FILE keeps every section in one JSON file (default).
+ * CONFIG_LAYOUT_SHARDED stores each section in its own file under a directory
+ * with a small manifest, so a save rewrites only the sections that changed.
+ */
+enum configStorageLayout : uint8_t {
+    CONFIG_LAYOUT_SINGLE_FILE = 0,
+    CONFIG_LAYOUT_SHARDED
+};
+
+/**
+ * @brief Where configManager::loadAll() spent its time on one domain.
+ */
+struct domainLoadTiming {
+    String domain;
+    size_t bytes;                  // JSON read from flash (0: defaults)
+    unsigned long readMicros;      // Flash reads, on the calling task
+    unsigned long parseMicros;     // JSON parsing, on whichever core picked it up
+    bool loaded;
+};
+
 //class configManager CONFIG_BASE_CLASS
 class configManager : public iConfigProvider
 {
     #ifdef TESTBENCH
     friend class testLib;
     #endif
+    friend class asyncSaveWorker;
+    friend class configTransaction;
 private:
     iFileSystemProvider* _fsProvider;
     std::map<String, std::map<String, String>> _configMap;
@@ -85,24 +121,113 @@ private:
     String _configFilePath;
 
     bool _isConfigLoaded;
+
+    // Storage layout and change tracking
+    configStorageLayout _storageLayout;
+    String _shardDirectory;
+    std::set<String> _dirtySections;   // Sections changed since the last load/save
+    std::set<String> _shardSections;   // Sections listed in the on-flash shard manifest
+
+    // Write budget
+    writeGovernor* _writeGovernor;
+    bool _saveDeferred;                // A governed saveConfig() is waiting for budget
+    uint32_t _savesDeferred;
+    uint32_t _savesCoalesced;
+
+    // Cross-task access; null until enableConcurrency()
+    configLock* _lock;
+
+    // Published read-only versions (see configView)
+    bool _snapshotsEnabled;
+    configViewPtr _view;               // Only touched through std::atomic_load/atomic_store
+    uint32_t _viewVersion;
+
+    // Change versions for conditional web requests
+    std::atomic<uint32_t> _changeVersion;
+    std::map<String, uint32_t> _sectionVersions;   // Store version of each section's last change
+    const uint32_t _versionEpoch;                   // Random per instance, keeps ETags unique across reboots
+
+    // Change subscriptions
+    struct subscription {
+        uint16_t id;
+        String section;                // Empty: every section
+        String key;                    // Empty: every key of the section
+        configChangeCallback callback;
+        void* context;
+        configChangeQueue* queue;
+    };
+    struct notification {
+        configChangeCallback callback;
+        void* context;
+        String section;
+        String key;
+    };
+    std::vector<subscription> _subscriptions;
+    uint16_t _nextSubscriptionId;
+
+    // Posted updates from ISRs / real-time tasks (see configUpdateQueue)
+    std::vector<configUpdateQueue*> _updateQueues;
+    uint32_t _updatesApplied;
+    uint32_t _updatesRejected;
     
     // Domain registration for web interface
     String _domainName;
     bool _isDefaultDomain;
-    
-    // Static registry for all config domains
-    static std::map<String, configManager*> _domainRegistry;
-    static configManager* _defaultDomain;
+    uint16_t _domainId;                // Slot in domainRegistry, DOMAIN_ID_NONE if unregistered
 
-    bool begin(String filename, bool verbose = true);
+    // One load split into flash reads, parsing and installing (see loadAll())
+    struct storedConfig {
+        configManager* owner = nullptr;
+        bool fromShards = false;       // Manifest found: shards holds the sections
+        String json;                   // Single file, or defaults
+        std::vector<std::pair<String, String>> shards;   // Section, shard JSON
+        size_t bytes = 0;
+        unsigned long readMicros = 0;
+        unsigned long parseMicros = 0;
+        std::map<String, std::map<String, String>> map;
+        std::set<String> shardSections;
+        std::set<String> dirtySections;
+    };
+
+    bool begin(String filename, bool verbose = true, std::vector<notification>* notifications = nullptr);
     bool loadConfigString(const char* filename, String* jsonString, bool verbose = true);
     bool jsonStringToMap(const String& jsonString, std::map<String, std::map<String, String>>& configMap, bool verbose = false);
-    bool jsonStringToConfig(const String& jsonString, bool verbose = false);
     String mapToJsonString(const std::map<String, std::map<String, String>>& configMap) const;
     bool saveToJson(const String& path, const std::map<String, std::map<String, String>>& configMap) const;
+    size_t writeJson(const String& path, const std::map<String, std::map<String, String>>& configMap) const;
     bool saveConfigFile(const char* filename);
     String loadDefaults() const;
     const std::map<String, std::map<String, String>>& getConfig() const;
+    void readStored(storedConfig& stored, bool verbose);
+    void parseStored(storedConfig& stored, bool verbose);
+    bool installStored(storedConfig& stored, bool verbose, std::vector<notification>* notifications);
+    static void parseStoredJob(size_t index, void* context);
+    bool saveShards(const std::map<String, std::map<String, String>>& sections, const std::vector<String>* manifest) const;
+    bool writeShards(const std::map<String, std::map<String, String>>& sections, const std::vector<String>* manifest, size_t& totalWritten) const;
+    bool collectShardChanges(const std::set<String>& sections, std::map<String, std::map<String, String>>& dirty, std::vector<String>& manifest) const;
+    void commitShardChanges(const std::vector<String>& manifest);
+    std::set<String> takeDirtySections();
+    void restoreDirtySections(const std::set<String>& sections);
+    void finishAsyncSave(bool saved, const std::set<String>& sections, const std::vector<String>* manifest);
+    std::shared_ptr<configView> buildView() const;
+    void publishView(const String* changedSection);
+    void publishView(const std::set<String>& changedSections);
+    void refreshViewSection(configView& view, const String& section) const;
+    void storeView(std::shared_ptr<configView>& next);
+    void applyTransaction(const std::vector<configOperation>& operations);
+    void applyOperations(const std::vector<configOperation>& operations);
+    uint16_t addSubscription(const String& section, const String& key, configChangeCallback callback, void* context, configChangeQueue* queue);
+    void queueNotifications(const String& section, const String& key, std::vector<notification>& notifications);
+    std::set<String> diffSections(const std::map<String, std::map<String, String>>& before, bool includeNewSections, std::vector<notification>& notifications);
+    void bumpVersion(const String& section);
+    void bumpVersion(const std::set<String>& sections);
+    size_t exportSections(Print& out, const std::vector<String>* sections) const;
+    static void exportSection(configJsonWriter& writer, const String& name, const std::map<String, String>& fields, bool& first);
+    void dispatchNotifications(const std::vector<notification>& notifications);
+    bool saveNow();
+    void deferSave();
+    bool writeDirty(size_t& written);
+    void printConfigMap() const;
 
 public:
     explicit configManager(iFileSystemProvider* fsProvider, const String& configFilePath = "/config.json", size_t maxConfigSize = 8192);
@@ -112,11 +237,27 @@ public:
     void setDomain(const String& domainName, bool isDefault = false);
     String getDomain() const { return _domainName; }
     bool isDefaultDomain() const { return _isDefaultDomain; }
+    uint16_t getDomainId() const { return _domainId; }
     
-    // Static methods to access domain registry
+    // Static methods to access domain registry (wait-free, any task; see domainRegistry)
     static std::vector<String> getDomainNames();
     static configManager* getDomain(const String& domainName);
     static configManager* getDefaultDomain();
+    // Resolve a name once, then look up by id in O(1)
+    static uint16_t findDomainId(const String& domainName) { return domainRegistry::findId(domainName); }
+    static configManager* getDomain(uint16_t domainId) { return domainRegistry::find(domainId); }
+
+    // Saves every registered domain with unsaved changes. Domains on the same
+    // filesystem share one mount session and one flash wear update. Write
+    // governors apply as in saveConfig(). False if any domain failed.
+    static bool saveAllDirty();
+    bool hasUnsavedChanges() const;   // Dirty sections or a deferred save
+
+    // Reloads every registered domain. Files are read on the calling task
+    // (one mount per filesystem), parsing runs on all cores. Optional
+    // per-domain timing in registry (name) order. False if any domain
+    // came up empty.
+    static bool loadAll(std::vector<domainLoadTiming>* timings = nullptr);
 
     String getValue(const String& section, const String& key) const CONFIG_OVERRIDE;
     void setValue(const String& section, const String& key, const String& value) CONFIG_OVERRIDE;
@@ -155,8 +296,12 @@ public:
     String getPassword() const CONFIG_OVERRIDE;
 
     void printConfigToSerial() const;
+    // Both return references into the live map: with concurrency enabled
+    // another task may change or drop the section while the caller holds one.
+    // Use getSectionCopy() / setValue() across tasks instead.
     std::map<String, String>& getSection(const String& sectionName);
     const std::map<String, String>& getSection(const String& sectionName) const CONFIG_OVERRIDE;
+    std::map<String, String> getSectionCopy(const String& sectionName) const;
     bool parseHexStringToBytes(const String& hexInput, uint8_t* outputBuffer, size_t bufferLen) const;
 
     // iConfigProvider interface implementation
@@ -165,10 +310,119 @@ public:
     std::vector<String> getKeys(const String& section) const CONFIG_OVERRIDE;
     bool saveConfig() CONFIG_OVERRIDE;
     bool loadConfig() CONFIG_OVERRIDE;
+
+    // Write-behind persistence: snapshots the config and returns immediately;
+    // the background worker writes it and calls callback from its own context.
+    // Returns false when the save queue is full (see asyncSaveWorker). A
+    // failed or cancelled job leaves its sections dirty for the next save.
+    // Governed like saveConfig(): over budget nothing is queued, the callback
+    // is not called and serviceDeferredSave() writes the changes later.
+    bool saveConfigAsync(asyncSaveCallback callback = nullptr, void* context = nullptr);
+
+    // Storage layout; call before loadConfig(). Switching to CONFIG_LAYOUT_SHARDED
+    // marks every section dirty; loads fall back to the single file until a
+    // manifest exists. Default shard directory is the config path without
+    // ".json" plus ".d".
+    void setStorageLayout(configStorageLayout layout, const String& shardDirectory = "");
+    configStorageLayout getStorageLayout() const { return _storageLayout; }
+    String getShardDirectory() const { return _shardDirectory; }
+    String getShardPath(const String& section) const;
+    String getShardManifestPath() const;
+    size_t getDirtySectionCount() const { return _dirtySections.size(); }
+
+    // Change notification instead of polling. An empty key watches the whole
+    // section, an empty section everything. Callbacks run in the changing
+    // task; a queue subscription pushes a configChangeEvent instead (one
+    // consumer task drains it). Returns the subscription id, 0 on failure.
+    // Changes made through the getSection() reference are not reported.
+    uint16_t subscribe(const String& section, const String& key, configChangeCallback callback, void* context = nullptr);
+    uint16_t subscribe(const String& section, const String& key, configChangeQueue* queue);
+    bool unsubscribe(uint16_t id);
+
+    // Real-time ingestion: attach one configUpdateQueue per producer (before
+    // it starts posting), then call serviceUpdates() from a normal task; it
+    // applies up to maxUpdates queued values as one transaction and returns
+    // how many it applied.
+    void attachUpdateQueue(configUpdateQueue* queue);
+    void detachUpdateQueue(configUpdateQueue* queue);
+    size_t serviceUpdates(size_t maxUpdates = SIZE_MAX);
+    uint32_t getUpdatesApplied() const { return _updatesApplied; }
+    uint32_t getUpdatesRejected() const { return _updatesRejected; }   // Address out of range
+    uint32_t getUpdateOverflows() const;                                // Posts dropped on full queues
+
+    // Stages several set/remove operations and applies them in one mutation
+    // on commit() (see configTransaction)
+    configTransaction beginTransaction() { return configTransaction(this); }
+
+    // Reloads one section from flash (its shard, or the single file), discarding unsaved changes to it
+    bool loadSection(const String& section);
+
+    // Write budget (see writeGovernor). With a governor, saveConfig() returns
+    // true but leaves the changes in RAM when the budget is spent; call
+    // serviceDeferredSave() from loop() to write them once it allows.
+    // flushConfig() saves now regardless (shutdown, OTA). saveConfigAsync()
+    // is not governed.
+    void setWriteGovernor(writeGovernor* governor) { _writeGovernor = governor; }
+    writeGovernor* getWriteGovernor() const { return _writeGovernor; }
+    bool serviceDeferredSave();
+    bool flushConfig();
+    bool isSaveDeferred() const { return _saveDeferred; }
+    uint32_t getSavesDeferred() const { return _savesDeferred; }     // saveConfig() calls held back
+    uint32_t getSavesCoalesced() const { return _savesCoalesced; }   // ...that merged into an already pending save
+
+    // Reader-writer locking for configs shared between tasks (see configLock).
+    // Off by default: single-task users pay nothing. Enable before a second
+    // task can reach this config; getValue() and the other readers then run
+    // in parallel while setValue(), loads and saves' bookkeeping are exclusive.
+    void enableConcurrency();
+    bool isConcurrencyEnabled() const { return _lock != nullptr; }
+
+    // RCU-style snapshots: every change publishes an immutable configView and
+    // getValue(), getSectionCopy(), getSections() and getKeys() read the
+    // current one without taking the config lock, so readers never wait for
+    // a writer's map update or a loadConfig() rebuild. The shared_ptr load
+    // itself is not lock-free (libstdc++ uses a short internal mutex).
+    // Costs a copy of the changed section per setValue(). Enable before other
+    // tasks start; concurrent writers still need enableConcurrency().
+    void enableSnapshots();
+    bool isSnapshotsEnabled() const { return _snapshotsEnabled; }
+    // Current version; with snapshots disabled a private copy is built
+    configViewPtr getView() const;
+    // Republish after changing a section through the getSection() reference
+    void publishView();
+
+    // Change versions, e.g. for HTTP ETag / If-None-Match. The store version
+    // goes up once per effective change (a setValue() with a new value, a
+    // transaction, a reload or clear that altered something); a section's
+    // version is the store version of its last change, 0 if it never had one.
+    // Edits through the getSection() reference are not seen.
+    uint32_t getVersion() const { return _changeVersion.load(std::memory_order_acquire); }
+    uint32_t getSectionVersion(const String& section) const;
+    // Quoted strong ETag ("<epoch>-<version>"); the epoch differs per boot
+    String getETag() const;
+    String getETag(const String& section) const;
+    // True when an If-None-Match header names the current ETag (or is "*")
+    bool matchesETag(const String& ifNoneMatch) const;
+    bool matchesETag(const String& ifNoneMatch, const String& section) const;
+
+    // Streams {"section":{"key":"value",...},...} to any Print (a chunked web
+    // response, a file, Serial) through a CONFIG_EXPORT_BUFFER_SIZE stack
+    // buffer. Sections that do not exist are left out. With snapshots the
+    // current view is streamed as is; otherwise each section is copied under
+    // the shared lock and streamed after releasing it, so every section is
+    // consistent on its own. Either way a slow sink never blocks writers.
+    // Returns bytes accepted by the sink.
+    size_t exportJson(Print& out) const;
+    size_t exportJson(Print& out, const String& section) const;
+    size_t exportJson(Print& out, const std::vector<String>& sections) const;
+
+    bool isAsyncSavePending() const { return asyncSaveWorker::isPending(this); }
+    bool waitForAsyncSave(uint32_t timeoutMs = UINT32_MAX) const { return asyncSaveWorker::wait(this, timeoutMs); }
     void printHeapStatus() const;
     size_t getConfigMemoryUsage() const;
     bool clearConfig();
     
     // Get filesystem provider for use by web server modules
     iFileSystemProvider* getFileSystemProvider() const { return _fsProvider; }
+    String getConfigFilePath() const { return _configFilePath; }
 };
\ No newline at end of file
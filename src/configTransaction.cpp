@@ -0,0 +1,53 @@
+#include <configTransaction.hpp>
+#include <configManager.hpp>
+
+configTransaction::configTransaction(configManager* owner) :
+    _owner(owner),
+    _open(owner != nullptr)
+{
+}
+
+configTransaction& configTransaction::setValue(const String& section, const String& key, const String& value)
+{
+    return stage(CONFIG_OP_SET, section, key, value);
+}
+
+configTransaction& configTransaction::removeValue(const String& section, const String& key)
+{
+    return stage(CONFIG_OP_REMOVE_KEY, section, key, "");
+}
+
+configTransaction& configTransaction::removeSection(const String& section)
+{
+    return stage(CONFIG_OP_REMOVE_SECTION, section, "", "");
+}
+
+configTransaction& configTransaction::stage(configOperationType type, const String& section, const String& key, const String& value)
+{
+    if (_open)
+    {
+        _operations.push_back({type, section, key, value});
+    }
+    return *this;
+}
+
+bool configTransaction::commit()
+{
+    if (!_open)
+    {
+        return false;
+    }
+    _open = false;
+    if (!_operations.empty())
+    {
+        _owner->applyTransaction(_operations);
+    }
+    _operations.clear();
+    return true;
+}
+
+void configTransaction::rollback()
+{
+    _open = false;
+    _operations.clear();
+}
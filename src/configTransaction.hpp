@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+class configManager;
+
+enum configOperationType : uint8_t {
+    CONFIG_OP_SET = 0,
+    CONFIG_OP_REMOVE_KEY,
+    CONFIG_OP_REMOVE_SECTION
+};
+
+struct configOperation {
+    configOperationType type;
+    String section;
+    String key;
+    String value;
+};
+
+/**
+ * @brief Batch of config changes applied all at once.
+ *
+ * Operations are staged in the transaction and touch nothing until commit(),
+ * which applies them in order inside one configManager mutation: one writer
+ * lock, one snapshot publish and one dirty mark per section. Readers and
+ * saves see either none or all of the batch. rollback() (or destroying an
+ * uncommitted transaction) discards the staged operations.
+ *
+ * Usage:
+ *   configTransaction txn = config.beginTransaction();
+ *   txn.setValue("wifi", "ssid", ssid)
+ *      .setValue("wifi", "password", password)
+ *      .removeValue("wifi", "bssid");
+ *   if (!valid) txn.rollback(); else txn.commit();
+ */
+class configTransaction
+{
+public:
+    explicit configTransaction(configManager* owner);
+
+    configTransaction& setValue(const String& section, const String& key, const String& value);
+    configTransaction& removeValue(const String& section, const String& key);
+    configTransaction& removeSection(const String& section);
+
+    // Applies the staged operations; false if already committed or rolled back
+    bool commit();
+    void rollback();
+
+    bool isOpen() const { return _open; }
+    size_t getOperationCount() const { return _operations.size(); }
+
+private:
+    configTransaction& stage(configOperationType type, const String& section, const String& key, const String& value);
+
+    configManager* _owner;
+    std::vector<configOperation> _operations;
+    bool _open;
+};
@@ -0,0 +1,37 @@
+#include <configUpdateQueue.hpp>
+
+bool CONFIG_ISR_ATTR configUpdateQueue::post(eePromAddress_t address, int32_t value)
+{
+    configUpdate update;
+    update.address = address;
+    update.type = CONFIG_UPDATE_INT;
+    update.decimals = 0;
+    update.intValue = value;
+    return _queue.push(update);
+}
+
+bool CONFIG_ISR_ATTR configUpdateQueue::post(eePromAddress_t address, float value, uint8_t decimals)
+{
+    configUpdate update;
+    update.address = address;
+    update.type = CONFIG_UPDATE_FLOAT;
+    update.decimals = decimals;
+    update.floatValue = value;
+    return _queue.push(update);
+}
+
+bool CONFIG_ISR_ATTR configUpdateQueue::post(eePromAddress_t address, const char* text)
+{
+    configUpdate update;
+    update.address = address;
+    update.type = CONFIG_UPDATE_TEXT;
+    update.decimals = 0;
+    // No strncpy: keep the ISR path free of library calls that may live in flash
+    uint8_t i = 0;
+    for (; text && text[i] && i < CONFIG_UPDATE_TEXT_LEN - 1; i++)
+    {
+        update.text[i] = text[i];
+    }
+    update.text[i] = '\0';
+    return _queue.push(update);
+}
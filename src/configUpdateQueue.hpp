@@ -0,0 +1,74 @@
+#pragma once
+
+#include <Arduino.h>
+#include <addressMapping.hpp>
+#include <spscQueue.hpp>
+
+// Producer functions must stay callable while the flash cache is off (ISR on ESP32)
+#if defined(ESP32) || defined(ESP8266)
+#define CONFIG_ISR_ATTR IRAM_ATTR
+#else
+#define CONFIG_ISR_ATTR
+#endif
+
+const uint16_t CONFIG_UPDATE_QUEUE_DEPTH = 32;   // Updates one producer can post between drains
+const uint8_t CONFIG_UPDATE_TEXT_LEN = 12;       // Including the terminator; longer text is truncated
+
+enum configUpdateType : uint8_t {
+    CONFIG_UPDATE_INT = 0,
+    CONFIG_UPDATE_FLOAT,
+    CONFIG_UPDATE_TEXT
+};
+
+/**
+ * @brief One posted value for a pre-resolved address (see addressMap).
+ *
+ * Fixed size and trivially copyable so it can travel through a queue
+ * without touching the heap; the value is turned into a String only when
+ * configManager drains it.
+ */
+struct configUpdate {
+    eePromAddress_t address;
+    configUpdateType type;
+    uint8_t decimals;                   // CONFIG_UPDATE_FLOAT only
+    union {
+        int32_t intValue;
+        float floatValue;
+        char text[CONFIG_UPDATE_TEXT_LEN];
+    };
+};
+
+/**
+ * @brief Allocation-free, lock-free channel from real-time code into a configManager.
+ *
+ * An ISR or high-priority task posts values for addresses from
+ * eepromAddressDefinitions.h; configManager::serviceUpdates(), called from a
+ * normal task, applies everything queued as one transaction. Each queue has
+ * exactly one producer: give the encoder ISR and the motor task one each.
+ * A post to a full queue is dropped and counted in getOverflows().
+ *
+ * Usage:
+ *   configUpdateQueue encoderUpdates;
+ *   state.attachUpdateQueue(&encoderUpdates);
+ *   void IRAM_ATTR onEncoder() { encoderUpdates.post(eePRESENT, position); }
+ *   loop() { state.serviceUpdates(); }
+ */
+class configUpdateQueue
+{
+public:
+    // Producer side: no heap, no locks (definitions carry CONFIG_ISR_ATTR)
+    bool post(eePromAddress_t address, int32_t value);
+    bool post(eePromAddress_t address, float value, uint8_t decimals = 2);
+    bool post(eePromAddress_t address, const char* text);
+
+    // Consumer side (configManager::serviceUpdates())
+    bool take(configUpdate& update) { return _queue.pop(update); }
+    uint16_t size() const { return _queue.size(); }
+
+    // Statistics
+    uint32_t getOverflows() const { return _queue.getOverflows(); }
+    uint16_t getHighWater() const { return _queue.getHighWater(); }
+
+private:
+    spscQueue<configUpdate, CONFIG_UPDATE_QUEUE_DEPTH> _queue;
+};
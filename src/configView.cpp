@@ -0,0 +1,53 @@
+#include <configView.hpp>
+
+String configView::getValue(const String &sectionName, const String &key) const
+{
+    auto sectionIt = _sections.find(sectionName);
+    if (sectionIt == _sections.end())
+    {
+        return "[NOT FOUND]";
+    }
+
+    auto valueIt = sectionIt->second->find(key);
+    if (valueIt == sectionIt->second->end())
+    {
+        return "[NOT FOUND]";
+    }
+
+    return valueIt->second;
+}
+
+const configView::section &configView::getSection(const String &sectionName) const
+{
+    static const section EMPTY_SECTION;
+    auto it = _sections.find(sectionName);
+    return it != _sections.end() ? *it->second : EMPTY_SECTION;
+}
+
+std::vector<String> configView::getSections() const
+{
+    std::vector<String> sections;
+    sections.reserve(_sections.size());
+    for (const auto &entry : _sections)
+    {
+        sections.push_back(entry.first);
+    }
+    return sections;
+}
+
+std::vector<String> configView::getKeys(const String &sectionName) const
+{
+    std::vector<String> keys;
+    auto it = _sections.find(sectionName);
+    if (it == _sections.end())
+    {
+        return keys;
+    }
+
+    keys.reserve(it->second->size());
+    for (const auto &kv : *it->second)
+    {
+        keys.push_back(kv.first);
+    }
+    return keys;
+}
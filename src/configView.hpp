@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Immutable, reference-counted version of a configManager's data.
+ *
+ * With snapshots enabled (configManager::enableSnapshots()) every change
+ * publishes a new configView and readers pick up the current one with
+ * std::atomic_load on the shared_ptr. They never wait for the config lock
+ * or for a loadConfig() rebuilding the whole map. That load is not
+ * lock-free: libstdc++ guards it with a short internal mutex that the
+ * publishing writer also takes for the pointer swap. A view never changes after
+ * it is published; a reader holding one keeps seeing that version and it is
+ * freed when the last holder lets go.
+ *
+ * Sections are shared between versions: a setValue() copies the one section
+ * it changes plus the section index, the other sections are reused.
+ *
+ * Usage:
+ *   configViewPtr view = config.getView();
+ *   String ssid = view->getValue("wifi", "ssid");
+ *   String pass = view->getValue("wifi", "password");   // same version as ssid
+ */
+class configView
+{
+public:
+    typedef std::map<String, String> section;
+
+    String getValue(const String& sectionName, const String& key) const;
+    const section& getSection(const String& sectionName) const;
+    bool hasSection(const String& sectionName) const { return _sections.find(sectionName) != _sections.end(); }
+    std::vector<String> getSections() const;
+    std::vector<String> getKeys(const String& sectionName) const;
+    size_t getSectionCount() const { return _sections.size(); }
+
+    // Increases with every published version of the same configManager
+    uint32_t getVersion() const { return _version; }
+
+private:
+    friend class configManager;
+
+    std::map<String, std::shared_ptr<const section>> _sections;
+    uint32_t _version = 0;
+};
+
+typedef std::shared_ptr<const configView> configViewPtr;
@@ -0,0 +1,224 @@
+#include <domainRegistry.hpp>
+#include <configLock.hpp>
+#include <algorithm>
+
+std::atomic<const domainRegistry::table*> domainRegistry::_current(nullptr);
+std::atomic<uint32_t> domainRegistry::_readers(0);
+std::vector<const domainRegistry::table*> domainRegistry::_retired;
+
+static configLock& writerLock()
+{
+    // Built on first use: FreeRTOS objects are not created during static initialization
+    static configLock lock;
+    return lock;
+}
+
+uint32_t domainRegistry::hashName(const String& name)
+{
+    // FNV-1a: lets lookups skip most string compares
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < name.length(); i++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+    }
+    return hash;
+}
+
+const domainRegistry::table* domainRegistry::acquire()
+{
+    // Counted before the load: a writer that then sees zero readers knows nobody holds the old table
+    _readers.fetch_add(1, std::memory_order_seq_cst);
+    return _current.load(std::memory_order_seq_cst);
+}
+
+void domainRegistry::release()
+{
+    _readers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+int domainRegistry::indexOf(const table* current, const String& name, uint32_t hash)
+{
+    if (!current)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < current->entries.size(); i++)
+    {
+        const entry& slot = current->entries[i];
+        if (slot.nameHash == hash && slot.name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void domainRegistry::publish(table* next)
+{
+    // Writer lock held
+    const table* previous = _current.exchange(next, std::memory_order_seq_cst);
+    if (previous)
+    {
+        _retired.push_back(previous);
+    }
+    if (_readers.load(std::memory_order_seq_cst) == 0)
+    {
+        for (const table* old : _retired)
+        {
+            delete old;
+        }
+        _retired.clear();
+    }
+}
+
+uint16_t domainRegistry::add(const String& name, configManager* config, bool isDefault)
+{
+    if (name.length() == 0 || !config)
+    {
+        return DOMAIN_ID_NONE;
+    }
+
+    configExclusiveGuard guard(&writerLock());
+    const table* current = _current.load(std::memory_order_acquire);
+    table* next = current ? new table(*current) : new table{std::vector<entry>(), nullptr};
+    const uint32_t hash = hashName(name);
+    int index = indexOf(next, name, hash);
+    if (index < 0)
+    {
+        next->entries.push_back({name, hash, config});
+        index = static_cast<int>(next->entries.size()) - 1;
+    }
+    else
+    {
+        next->entries[index].config = config;
+    }
+    if (isDefault || !next->defaultDomain)
+    {
+        next->defaultDomain = config;
+    }
+    publish(next);
+    return static_cast<uint16_t>(index + 1);
+}
+
+void domainRegistry::remove(configManager* config)
+{
+    configExclusiveGuard guard(&writerLock());
+    const table* current = _current.load(std::memory_order_acquire);
+    if (!current)
+    {
+        return;
+    }
+    bool found = current->defaultDomain == config;
+    for (const entry& slot : current->entries)
+    {
+        found = found || slot.config == config;
+    }
+    if (!found)
+    {
+        return;
+    }
+
+    table* next = new table(*current);
+    for (entry& slot : next->entries)
+    {
+        if (slot.config == config)
+        {
+            slot.config = nullptr;
+        }
+    }
+    if (next->defaultDomain == config)
+    {
+        next->defaultDomain = nullptr;
+    }
+    publish(next);
+}
+
+configManager* domainRegistry::find(uint16_t id)
+{
+    const table* current = acquire();
+    configManager* config = nullptr;
+    if (current && id != DOMAIN_ID_NONE && id <= current->entries.size())
+    {
+        config = current->entries[id - 1].config;
+    }
+    release();
+    return config;
+}
+
+configManager* domainRegistry::find(const String& name)
+{
+    const uint32_t hash = hashName(name);
+    const table* current = acquire();
+    const int index = indexOf(current, name, hash);
+    configManager* config = (index >= 0) ? current->entries[index].config : nullptr;
+    release();
+    return config;
+}
+
+uint16_t domainRegistry::findId(const String& name)
+{
+    const uint32_t hash = hashName(name);
+    const table* current = acquire();
+    const int index = indexOf(current, name, hash);
+    const bool live = index >= 0 && current->entries[index].config;
+    release();
+    return live ? static_cast<uint16_t>(index + 1) : DOMAIN_ID_NONE;
+}
+
+configManager* domainRegistry::getDefault()
+{
+    const table* current = acquire();
+    configManager* config = current ? current->defaultDomain : nullptr;
+    release();
+    return config;
+}
+
+std::vector<String> domainRegistry::getNames()
+{
+    std::vector<String> names;
+    const table* current = acquire();
+    if (current)
+    {
+        names.reserve(current->entries.size());
+        for (const entry& slot : current->entries)
+        {
+            if (slot.config)
+            {
+                names.push_back(slot.name);
+            }
+        }
+    }
+    release();
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+std::vector<configManager*> domainRegistry::getAll()
+{
+    std::vector<const entry*> live;
+    std::vector<configManager*> configs;
+    const table* current = acquire();
+    if (current)
+    {
+        for (const entry& slot : current->entries)
+        {
+            if (slot.config)
+            {
+                live.push_back(&slot);
+            }
+        }
+        std::sort(live.begin(), live.end(), [](const entry* a, const entry* b) { return a->name < b->name; });
+        for (const entry* slot : live)
+        {
+            configs.push_back(slot->config);
+        }
+    }
+    release();
+    return configs;
+}
+
+size_t domainRegistry::getRetiredTables()
+{
+    configExclusiveGuard guard(&writerLock());
+    return _retired.size();
+}
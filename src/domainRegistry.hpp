@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <vector>
+
+class configManager;
+
+const uint16_t DOMAIN_ID_NONE = 0;
+
+/**
+ * @brief Process-wide registry of named configManager domains.
+ *
+ * Web handlers on other tasks look domains up while setDomain() and
+ * configManager destructors change the registry, so the table is
+ * copy-on-write: writers (serialized by a configLock) build a new immutable
+ * table and publish it with one atomic pointer store. Readers increment an
+ * atomic reader count, load the pointer, read and decrement again - no lock,
+ * no retry loop, so lookups are wait-free.
+ *
+ * A replaced table is retired rather than freed. A writer frees the retired
+ * tables once it sees no reader inside; under constant lookup traffic they
+ * wait for the next quiet registry change.
+ *
+ * Every name keeps the id it was first given (1-based index into the
+ * table), so handlers can resolve a name once and use getDomain(id), a
+ * bounds check and an array read, from then on.
+ */
+class domainRegistry
+{
+public:
+    // Writers
+    static uint16_t add(const String& name, configManager* config, bool isDefault);
+    static void remove(configManager* config);
+
+    // Wait-free readers
+    static configManager* find(uint16_t id);
+    static configManager* find(const String& name);
+    static uint16_t findId(const String& name);
+    static configManager* getDefault();
+    static std::vector<String> getNames();
+    static std::vector<configManager*> getAll();   // Registered configs, in name order
+
+    // Statistics
+    static size_t getRetiredTables();
+
+private:
+    struct entry {
+        String name;
+        uint32_t nameHash;
+        configManager* config;      // nullptr once unregistered; the slot keeps its id
+    };
+    struct table {
+        std::vector<entry> entries;
+        configManager* defaultDomain;
+    };
+
+    static uint32_t hashName(const String& name);
+    static const table* acquire();
+    static void release();
+    static int indexOf(const table* current, const String& name, uint32_t hash);
+    static void publish(table* next);
+
+    static std::atomic<const table*> _current;
+    static std::atomic<uint32_t> _readers;
+    static std::vector<const table*> _retired;
+};
@@ -0,0 +1,50 @@
+#include <eepromByteStore.hpp>
+
+#ifndef CONFIGMGR_NATIVE
+#include <logger.hpp>
+
+// EEPROM.begin() reallocates the RAM image; only do it once
+static size_t _eepromSize = 0;
+
+bool eepromByteStore::begin(size_t size)
+{
+    if (_eepromSize != 0)
+    {
+        return true;
+    }
+#if defined(ESP32)
+    if (!EEPROM.begin(size))
+    {
+        LOG_ERROR(LOG_CAT_SYSTEM, "EEPROM: ERROR - Failed to initialize %u bytes", static_cast<unsigned>(size));
+        return false;
+    }
+    LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: EEPROM initialized with %u bytes for ESP32", static_cast<unsigned>(size));
+#elif defined(ESP8266)
+    EEPROM.begin(size);
+    LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: EEPROM initialized with %u bytes for ESP8266", static_cast<unsigned>(size));
+#endif
+    _eepromSize = size;
+    return true;
+}
+
+size_t eepromByteStore::length() const
+{
+    return EEPROM.length();
+}
+
+uint8_t eepromByteStore::read(size_t address) const
+{
+    return EEPROM.read(static_cast<int>(address));
+}
+
+void eepromByteStore::write(size_t address, uint8_t value)
+{
+    EEPROM.write(static_cast<int>(address), value);
+}
+
+bool eepromByteStore::commit()
+{
+    return EEPROM.commit();
+}
+
+#endif // !CONFIGMGR_NATIVE
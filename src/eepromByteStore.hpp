@@ -0,0 +1,28 @@
+#pragma once
+
+#ifndef CONFIGMGR_NATIVE
+#include <interface/iByteStore.hpp>
+
+#if defined(ESP32) || defined(ESP8266)
+#include <EEPROM.h>
+#else
+#error "EEPROM byte store only supports ESP32 and ESP8266 platforms"
+#endif
+
+/**
+ * @brief iByteStore over the ESP32/ESP8266 Arduino EEPROM emulation.
+ *
+ * All instances share the single global EEPROM object; begin() sizes it
+ * once and later calls reuse that size.
+ */
+class eepromByteStore : public iByteStore
+{
+public:
+    bool begin(size_t size) override;
+    size_t length() const override;
+    uint8_t read(size_t address) const override;
+    void write(size_t address, uint8_t value) override;
+    bool commit() override;
+};
+
+#endif // !CONFIGMGR_NATIVE
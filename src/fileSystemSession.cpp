@@ -0,0 +1,96 @@
+#include <fileSystemSession.hpp>
+#include <utility>
+#include <vector>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(CONFIGMGR_NATIVE)
+#include <mutex>
+#endif
+
+// Mount count per provider; only touched with the session lock held
+static std::vector<std::pair<iFileSystemProvider*, uint16_t>>& mounts()
+{
+    static std::vector<std::pair<iFileSystemProvider*, uint16_t>> active;
+    return active;
+}
+
+#if defined(ESP32)
+static SemaphoreHandle_t sessionLock()
+{
+    // Built on first use: FreeRTOS objects are not created during static initialization
+    static SemaphoreHandle_t lock = xSemaphoreCreateRecursiveMutex();
+    return lock;
+}
+#elif defined(CONFIGMGR_NATIVE)
+static std::recursive_mutex& sessionLock()
+{
+    static std::recursive_mutex lock;
+    return lock;
+}
+#endif
+
+static void lockSessions()
+{
+#if defined(ESP32)
+    xSemaphoreTakeRecursive(sessionLock(), portMAX_DELAY);
+#elif defined(CONFIGMGR_NATIVE)
+    sessionLock().lock();
+#endif
+}
+
+static void unlockSessions()
+{
+#if defined(ESP32)
+    xSemaphoreGiveRecursive(sessionLock());
+#elif defined(CONFIGMGR_NATIVE)
+    sessionLock().unlock();
+#endif
+}
+
+fileSystemSession::fileSystemSession(iFileSystemProvider* provider) :
+    _provider(provider),
+    _mounted(false)
+{
+    lockSessions();
+    if (!_provider)
+    {
+        return;
+    }
+    for (auto& mount : mounts())
+    {
+        if (mount.first == _provider)
+        {
+            mount.second++;
+            _mounted = true;
+            return;
+        }
+    }
+    if (_provider->begin())
+    {
+        mounts().emplace_back(_provider, 1);
+        _mounted = true;
+    }
+}
+
+fileSystemSession::~fileSystemSession()
+{
+    if (_mounted)
+    {
+        auto& active = mounts();
+        for (auto it = active.begin(); it != active.end(); ++it)
+        {
+            if (it->first == _provider)
+            {
+                if (--it->second == 0)
+                {
+                    active.erase(it);
+                    _provider->end();
+                }
+                break;
+            }
+        }
+    }
+    unlockSessions();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <interface/iFileSystemProvider.hpp>
+
+/**
+ * @brief Scoped, process-wide mount session on a filesystem provider.
+ *
+ * Provider instances of the same kind share one global mount (LittleFS,
+ * SPIFFS), so an end() from one task unmounts the filesystem under every
+ * other task using it. A session takes one process-wide recursive lock for
+ * its whole lifetime and mounts the provider on entry; sessions on other
+ * tasks wait until it is over. The mount is counted per provider: a nested
+ * session on the same provider (same task) neither mounts nor unmounts.
+ *
+ * configManager opens a session around every mount it makes, the async
+ * save worker included. Application code that uses the same filesystem from
+ * another task (a web handler serving files) should open one as well.
+ *
+ * Platforms without a threading layer (ESP8266) only count mounts.
+ *
+ * Usage:
+ *   fileSystemSession session(&flash);
+ *   if (session.isMounted()) { ... flash.readFile("/index.html") ... }
+ */
+class fileSystemSession
+{
+public:
+    explicit fileSystemSession(iFileSystemProvider* provider);
+    ~fileSystemSession();
+
+    // False when there is no provider or begin() failed
+    bool isMounted() const { return _mounted; }
+
+private:
+    fileSystemSession(const fileSystemSession&) = delete;
+    fileSystemSession& operator=(const fileSystemSession&) = delete;
+
+    iFileSystemProvider* _provider;
+    bool _mounted;
+};
@@ -1,44 +1,145 @@
 #include "flashWearCounter.hpp"
 #include <logger.hpp>
+#include <math.h>
+#include <string.h>
 
-// Platform-specific EEPROM includes
 #if defined(ESP32)
-    #include <EEPROM.h>
-#elif defined(ESP8266)
-    #include <EEPROM.h>
+    #include <esp_system.h>
+#endif
+
+#ifdef CONFIGMGR_NATIVE
+    #include "compat/ramByteStore.hpp"
 #else
-    #error "Flash wear counter only supports ESP32 and ESP8266"
+    #include "eepromByteStore.hpp"
 #endif
 
-#include <logger.hpp>
+static_assert(BOOT_COUNTER_LOG_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE == FLASH_WEAR_RECORD_SIZE, "Boot records keep the legacy record size");
 
-// Static variables for flash wear tracking
-static uint32_t _maxFlashWrites = DEFAULT_MAX_FLASH_WRITES;
-static uint16_t _counterAddress = DEFAULT_FLASH_WEAR_COUNTER_ADDRESS;
-static uint16_t _bootCounterAddress = DEFAULT_BOOT_COUNTER_ADDRESS;
-static uint32_t _flashWriteCount = 0;
-static uint32_t _bootCount = 0;
-static bool _flashWearInitialized = false;
-static bool _bootCounterInitialized = false;
-static unsigned long _lastReportTime = 0;
-static unsigned long _reportInterval = DEFAULT_REPORT_INTERVAL_MS;
-static bool _deviceRetired = false;
-static size_t _eepromLength = 0;
-
-// Warning thresholds
-static float _cautionThreshold = CAUTION_THRESHOLD;
-static float _criticalThreshold = CRITICAL_THRESHOLD;
-static float _retirementThreshold = RETIREMENT_THRESHOLD;
+// Wear record value slots
+enum {
+    WEAR_VALUE_WRITES = 0,
+    WEAR_VALUE_SECTORS,
+    WEAR_VALUE_BYTES_LOW,
+    WEAR_VALUE_BYTES_HIGH,
+    WEAR_VALUE_UPTIME,      // Seconds
+    WEAR_VALUE_RATE         // float bits, writes per hour
+};
 
-// Private helper functions
-static void _initializeEEPROM();
-static bool _readFlashWearRecord(uint16_t address, FlashWearRecord* record);
-static bool _writeFlashWearRecord(uint16_t address, const FlashWearRecord* record, const char* label);
+#if defined(ESP32)
+static void _flushOnShutdown();
+#endif
+
+flashWearCounter* flashWearCounter::_flushOnShutdownList = nullptr;
+
+flashWearCounter::flashWearCounter(iByteStore* store) :
+    _store(store),
+    _maxFlashWrites(DEFAULT_MAX_FLASH_WRITES),
+    _counterAddress(DEFAULT_FLASH_WEAR_COUNTER_ADDRESS),
+    _bootCounterAddress(DEFAULT_BOOT_COUNTER_ADDRESS),
+    _flashWriteCount(0),
+    _bytesWritten(0),
+    _sectorsErased(0),
+    _eraseCyclesPerBlock(0),
+    _eraseBlockCount(0),
+    _bootCount(0),
+    _flashWearInitialized(false),
+    _bootCounterInitialized(false),
+    _lastReportTime(0),
+    _reportInterval(DEFAULT_REPORT_INTERVAL_MS),
+    _deviceRetired(false),
+    _eepromLength(0),
+    _cautionThreshold(CAUTION_THRESHOLD),
+    _criticalThreshold(CRITICAL_THRESHOLD),
+    _retirementThreshold(RETIREMENT_THRESHOLD),
+    _logAddress(DEFAULT_FLASH_WEAR_LOG_ADDRESS),
+    _logLength(DEFAULT_FLASH_WEAR_LOG_LENGTH),
+    _bootLogSlots(DEFAULT_BOOT_COUNTER_LOG_SLOTS),
+    _wearLog(),
+    _bootLog(),
+    _commitEvery(DEFAULT_FLASH_WEAR_COMMIT_EVERY),
+    _commitWindowMs(DEFAULT_FLASH_WEAR_COMMIT_WINDOW_MS),
+    _pendingIncrements(0),
+    _firstPendingTime(0),
+    _commitCount(0),
+    _commitsAvoided(0),
+    _uptimeSeconds(0),
+    _uptimeMark(0),
+    _uptimeRemainderMs(0),
+    _writeRate(0.0f),
+    _writeRateKnown(false),
+    _rateAlpha(DEFAULT_WEAR_RATE_ALPHA),
+    _rateSampleMs(DEFAULT_WEAR_RATE_SAMPLE_MS),
+    _rateSampleTime(0),
+    _rateSampleWrites(0),
+    _bootCommitDeferred(false),
+    _bootCommitPending(false),
+    _bootTiming(),
+    _reportedWarningLevel(0),
+    _verboseLogging(false),
+    _flushOnShutdownListed(false),
+    _nextFlushOnShutdown(nullptr) {
+#if defined(ESP32)
+    _mutex = xSemaphoreCreateRecursiveMutex();
+#endif
+}
+
+flashWearCounter::~flashWearCounter() {
+    flush();
+    for (flashWearCounter** link = &_flushOnShutdownList; *link; link = &(*link)->_nextFlushOnShutdown) {
+        if (*link == this) {
+            *link = _nextFlushOnShutdown;
+            break;
+        }
+    }
+#if defined(ESP32)
+    vSemaphoreDelete(_mutex);
+#endif
+}
+
+flashWearCounter::scopedLock::scopedLock(const flashWearCounter* counter) : _counter(counter) {
+#if defined(ESP32)
+    xSemaphoreTakeRecursive(_counter->_mutex, portMAX_DELAY);
+#elif defined(CONFIGMGR_NATIVE)
+    _counter->_mutex.lock();
+#endif
+}
+
+flashWearCounter::scopedLock::~scopedLock() {
+#if defined(ESP32)
+    xSemaphoreGiveRecursive(_counter->_mutex);
+#elif defined(CONFIGMGR_NATIVE)
+    _counter->_mutex.unlock();
+#endif
+}
+
+/**
+ * Set the EEPROM region used for the counter logs
+ */
+bool flashWearCounter::setLogRegion(uint16_t address, uint16_t length, uint16_t bootSlots) {
+    scopedLock guard(this);
+    if (_flashWearInitialized) {
+        LOG_WARN(LOG_CAT_SYSTEM, "FlashWearCounter: Log region must be set before initialization");
+        return false;
+    }
+
+    const uint16_t wearRecordSize = FLASH_WEAR_LOG_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE;
+    if (bootSlots < 2 || length < bootSlots * FLASH_WEAR_RECORD_SIZE + 2 * wearRecordSize) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Log region of %u bytes too small for %u boot slots",
+                  static_cast<unsigned>(length), static_cast<unsigned>(bootSlots));
+        return false;
+    }
+
+    _logAddress = address;
+    _logLength = length;
+    _bootLogSlots = bootSlots;
+    return true;
+}
 
 /**
  * Initialize the flash wear counter system
  */
-bool initFlashWearCounter(uint32_t maxWrites, uint16_t counterAddress, uint16_t bootCounterAddress) {
+bool flashWearCounter::begin(uint32_t maxWrites, uint16_t counterAddress, uint16_t bootCounterAddress) {
+    scopedLock guard(this);
     if (_flashWearInitialized) {
         LOG_DEBUG(LOG_CAT_SYSTEM,  "FlashWearCounter: Already initialized");
         return true;
@@ -47,133 +148,151 @@ bool initFlashWearCounter(uint32_t maxWrites, uint16_t counterAddress, uint16_t
     _maxFlashWrites = maxWrites;
     _counterAddress = counterAddress;
     _bootCounterAddress = bootCounterAddress;
+    _bootTiming = {};
+    const unsigned long initStart = micros();
     
-    // Initialize EEPROM
-    _initializeEEPROM();
-    _eepromLength = EEPROM.length();
-
-    if (_eepromLength < FLASH_WEAR_RECORD_SIZE * 2) {
-        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - EEPROM length too small for wear and boot records");
+    if (!_store || !_store->begin(FLASH_WEAR_EEPROM_SIZE)) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Byte store unavailable");
         return false;
     }
+    _eepromLength = _store->length();
+    unsigned long phaseStart = micros();
+    _bootTiming.storeMicros = phaseStart - initStart;
 
-    if (_counterAddress > _eepromLength - FLASH_WEAR_RECORD_SIZE) {
-        uint16_t adjustedAddress = static_cast<uint16_t>(_eepromLength - FLASH_WEAR_RECORD_SIZE);
-        LOG_WARN(LOG_CAT_SYSTEM, "FlashWearCounter: WARNING - Counter address %u out of range for EEPROM length %u. Adjusting to %u",
-                      static_cast<unsigned>(_counterAddress), static_cast<unsigned>(_eepromLength), static_cast<unsigned>(adjustedAddress));
-        _counterAddress = adjustedAddress;
-    }
-
-    if (_bootCounterAddress > _eepromLength - FLASH_WEAR_RECORD_SIZE) {
-        uint16_t fallback = (_counterAddress >= FLASH_WEAR_RECORD_SIZE)
-            ? static_cast<uint16_t>(_counterAddress - FLASH_WEAR_RECORD_SIZE)
-            : static_cast<uint16_t>(_eepromLength - FLASH_WEAR_RECORD_SIZE);
-        LOG_WARN(LOG_CAT_SYSTEM, "BootCounter: WARNING - Boot counter address %u out of range for EEPROM length %u. Adjusting to %u",
-                      static_cast<unsigned>(_bootCounterAddress), static_cast<unsigned>(_eepromLength), static_cast<unsigned>(fallback));
-        _bootCounterAddress = fallback;
+    if (_logAddress + static_cast<size_t>(_logLength) > _eepromLength) {
+        const uint16_t adjustedLength = (_logAddress < _eepromLength)
+            ? static_cast<uint16_t>(_eepromLength - _logAddress)
+            : 0;
+        LOG_WARN(LOG_CAT_SYSTEM, "FlashWearCounter: WARNING - Log region %u+%u out of range for EEPROM length %u. Adjusting length to %u",
+                 static_cast<unsigned>(_logAddress), static_cast<unsigned>(_logLength),
+                 static_cast<unsigned>(_eepromLength), static_cast<unsigned>(adjustedLength));
+        _logLength = adjustedLength;
     }
 
-    auto recordsOverlap = [](uint16_t a, uint16_t b) {
-        const uint16_t aEnd = static_cast<uint16_t>(a + FLASH_WEAR_RECORD_SIZE);
-        const uint16_t bEnd = static_cast<uint16_t>(b + FLASH_WEAR_RECORD_SIZE);
-        return (a <= b && aEnd > b) || (b <= a && bEnd > a);
-    };
-
-    if (recordsOverlap(_counterAddress, _bootCounterAddress)) {
-        uint16_t adjusted = (_counterAddress >= FLASH_WEAR_RECORD_SIZE)
-            ? static_cast<uint16_t>(_counterAddress - FLASH_WEAR_RECORD_SIZE)
-            : static_cast<uint16_t>(_counterAddress + FLASH_WEAR_RECORD_SIZE);
-
-        if (adjusted > _eepromLength - FLASH_WEAR_RECORD_SIZE) {
-            adjusted = 0;
-        }
-
-        LOG_WARN(LOG_CAT_SYSTEM, "BootCounter: WARNING - Address conflict between boot (%u) and wear (%u). Adjusting boot to %u\n",
-            static_cast<unsigned>(_bootCounterAddress), static_cast<unsigned>(_counterAddress), static_cast<unsigned>(adjusted));
-        _bootCounterAddress = adjusted;
-    }
+    // Wear ring first, boot ring in the tail of the region
+    _bootLog = {};
+    _bootLog.values = BOOT_COUNTER_LOG_VALUES;
+    _bootLog.slots = _bootLogSlots;
+    _wearLog = {};
+    _wearLog.values = FLASH_WEAR_LOG_VALUES;
+    _wearLog.address = _logAddress;
+    const uint16_t bootBytes = static_cast<uint16_t>(_bootLog.slots * recordSize(&_bootLog));
+    _wearLog.slots = (_logLength > bootBytes) ? static_cast<uint16_t>((_logLength - bootBytes) / recordSize(&_wearLog)) : 0;
+    _bootLog.address = static_cast<uint16_t>(_logAddress + _wearLog.slots * recordSize(&_wearLog));
 
-    if (_bootCounterAddress > _eepromLength - FLASH_WEAR_RECORD_SIZE) {
-        LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Unable to locate space for boot counter record");
+    if (_wearLog.slots < 2) {
+        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - EEPROM log region too small for wear and boot records");
         return false;
     }
 
     // Initialize boot counter and increment for this boot
-    FlashWearRecord bootRecord{};
-    (void)_readFlashWearRecord(_bootCounterAddress, &bootRecord);
+    uint32_t storedBoots = 0;
+    if (scanLog(&_bootLog, &storedBoots)) {
+        LOG_DEBUG(LOG_CAT_SYSTEM, "BootCounter: DEBUG - Newest log record in slot %u, sequence %u, value=%u\n",
+                  static_cast<unsigned>(_bootLog.head), static_cast<unsigned>(_bootLog.sequence),
+                  static_cast<unsigned>(storedBoots));
+        _bootCount = storedBoots;
+    } else {
+        // Empty log: seed from the legacy single record if there is one
+        FlashWearRecord bootRecord{};
+        (void)readLegacyRecord(_bootCounterAddress, &bootRecord);
 
-    LOG_DEBUG(LOG_CAT_SYSTEM, "BootCounter: DEBUG - Reading from EEPROM byte offset %u, valid=%d, value=%u\n",
-        static_cast<unsigned>(_bootCounterAddress), bootRecord.valid, bootRecord.value);
+        LOG_DEBUG(LOG_CAT_SYSTEM, "BootCounter: DEBUG - Reading legacy record at EEPROM byte offset %u, valid=%d, value=%u\n",
+            static_cast<unsigned>(_bootCounterAddress), bootRecord.valid, bootRecord.value);
 
-    if (bootRecord.valid == FLASH_WEAR_VALID) {
-        if (bootRecord.value <= BOOT_COUNTER_SANITY_LIMIT) {
+        if (bootRecord.valid == FLASH_WEAR_VALID) {
             _bootCount = bootRecord.value;
         } else {
-            LOG_WARN(LOG_CAT_SYSTEM, "BootCounter: Detected out-of-range value %u, resetting to 0", static_cast<unsigned>(bootRecord.value));
+            // Without a valid marker the bytes are erased or garbage: never guess a count from them
             _bootCount = 0;
+            LOG_INFO(LOG_CAT_SYSTEM, "BootCounter: Initializing boot counter to 0");
         }
-    } else {
-        _bootCount = (bootRecord.value != 0 && bootRecord.value != UINT32_MAX) ? bootRecord.value : 0;
-        LOG_INFO(LOG_CAT_SYSTEM, "BootCounter: Initializing boot counter to 0");
     }
 
-    uint32_t nextBootCount = (_bootCount == UINT32_MAX) ? UINT32_MAX : _bootCount + 1;
-    FlashWearRecord bootWrite{};
-    bootWrite.value = nextBootCount;
-    bootWrite.valid = FLASH_WEAR_VALID;
-    bootWrite.reserved[0] = 0;
-    bootWrite.reserved[1] = 0;
-    bootWrite.reserved[2] = 0;
-
-    if (!_writeFlashWearRecord(_bootCounterAddress, &bootWrite, "BootCounter")) {
-        LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Failed to persist boot counter");
-        return false;
+    if (_bootCount > BOOT_COUNTER_SANITY_LIMIT) {
+        LOG_WARN(LOG_CAT_SYSTEM, "BootCounter: Detected out-of-range value %u, resetting to 0", static_cast<unsigned>(_bootCount));
+        _bootCount = 0;
     }
 
+    // Staged only: every boot-time record goes out in the single commit below
+    uint32_t nextBootCount = (_bootCount == UINT32_MAX) ? UINT32_MAX : _bootCount + 1;
+    appendLog(&_bootLog, &nextBootCount, "BootCounter", false);
     _bootCount = nextBootCount;
     _bootCounterInitialized = true;
-
-    LOG_INFO(LOG_CAT_SYSTEM, "BootCounter: Boot count incremented to %u\n", 
-        static_cast<unsigned>(_bootCount));
+    _bootTiming.bootScanMicros = micros() - phaseStart;
+    phaseStart = micros();
     
-    // Read current write count from EEPROM
-    FlashWearRecord counterRecord{};
-    bool readSuccess = _readFlashWearRecord(_counterAddress, &counterRecord);
+    // Read current write count from the log
+    uint32_t stored[FLASH_WEAR_LOG_VALUES] = {0};
+    if (scanLog(&_wearLog, stored)) {
+        _flashWriteCount = stored[WEAR_VALUE_WRITES];
+        _sectorsErased = stored[WEAR_VALUE_SECTORS];
+        _bytesWritten = (static_cast<uint64_t>(stored[WEAR_VALUE_BYTES_HIGH]) << 32) | stored[WEAR_VALUE_BYTES_LOW];
+        _uptimeSeconds = stored[WEAR_VALUE_UPTIME];
+        float rate = 0.0f;
+        memcpy(&rate, &stored[WEAR_VALUE_RATE], sizeof(rate));
+        if (rate > 0.0f && isfinite(rate)) {
+            _writeRate = rate;
+            _writeRateKnown = true;
+        }
+        LOG_DEBUG(LOG_CAT_SYSTEM, "FlashWearCounter: Loaded existing counter: %u writes, %u sectors erased (%.2f%% of limit), log slot %u/%u\n", 
+                     _flashWriteCount, static_cast<unsigned>(_sectorsErased), getWearPercentage(),
+                     static_cast<unsigned>(_wearLog.head), static_cast<unsigned>(_wearLog.slots));
+    } else {
+        FlashWearRecord counterRecord{};
+        bool readSuccess = readLegacyRecord(_counterAddress, &counterRecord);
 
-    LOG_DEBUG(LOG_CAT_SYSTEM, "FlashWearCounter: DEBUG - Reading from EEPROM byte offset %u, valid=%d, value=%u\n", 
-              static_cast<unsigned>(_counterAddress), counterRecord.valid, counterRecord.value);
+        LOG_DEBUG(LOG_CAT_SYSTEM, "FlashWearCounter: DEBUG - Reading legacy record at EEPROM byte offset %u, valid=%d, value=%u\n", 
+                  static_cast<unsigned>(_counterAddress), counterRecord.valid, counterRecord.value);
 
-    if (readSuccess && counterRecord.valid == FLASH_WEAR_VALID) {
-        _flashWriteCount = counterRecord.value;
-        LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: Loaded existing counter: %u writes (%.2f%% of limit)\n", 
-                     _flashWriteCount, (float)_flashWriteCount / _maxFlashWrites * 100.0);
-    } else {
-        // First boot or corrupted counter - this is NORMAL, not an error
-        if (counterRecord.value > 0 && counterRecord.value < _maxFlashWrites) {
-            // Corrupted but reasonable value - preserve it
+        if (readSuccess && counterRecord.valid == FLASH_WEAR_VALID) {
             _flashWriteCount = counterRecord.value;
-            LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: Recovered counter from corrupted EEPROM: %u writes (%.2f%% of limit)\n", 
-                _flashWriteCount, (float)_flashWriteCount / _maxFlashWrites * 100.0);
+            LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: Migrated legacy counter: %u writes (%.2f%% of limit)\n", 
+                         _flashWriteCount, (float)_flashWriteCount / _maxFlashWrites * 100.0);
         } else {
-            // First boot or completely corrupted - initialize to 0
+            // First boot or completely corrupted - this is NORMAL, not an error
             _flashWriteCount = 0;
             LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: First boot - initializing counter to 0");
         }
         
-        // Write the counter back to EEPROM to fix the valid flag without incrementing
-        FlashWearRecord resetRecord;
-        resetRecord.value = _flashWriteCount;
-        resetRecord.valid = FLASH_WEAR_VALID;
-        resetRecord.reserved[0] = 0;
-        resetRecord.reserved[1] = 0;
-        resetRecord.reserved[2] = 0;
-
-        if (!_writeFlashWearRecord(_counterAddress, &resetRecord, "FlashWearCounter")) {
-            LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Failed to initialize counter record");
+        // Legacy records only counted writes: assume one erase each, bytes and uptime unknown
+        _sectorsErased = _flashWriteCount;
+        _bytesWritten = 0;
+        _uptimeSeconds = 0;
+
+        // Start the log without incrementing (committed with the boot record)
+        writeWearRecord(false);
+    }
+    
+    if (!_writeRateKnown && _uptimeSeconds >= 3600) {
+        // No stored average yet: start from the lifetime average
+        _writeRate = _flashWriteCount * 3600.0f / _uptimeSeconds;
+        _writeRateKnown = true;
+    }
+    // Uptime keeps counting from power-on (_uptimeMark 0); the rate from now
+    _rateSampleTime = millis();
+    _rateSampleWrites = _flashWriteCount;
+    _bootTiming.wearScanMicros = micros() - phaseStart;
+
+    // One commit for everything init changed, or none until the first idle moment
+    if (_bootCommitDeferred) {
+        _bootCommitPending = true;
+    } else {
+        phaseStart = micros();
+        if (!_store->commit()) {
+            LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Failed to persist boot counter");
             return false;
         }
+        _bootTiming.commitMicros = micros() - phaseStart;
+        _bootTiming.commits = 1;
     }
-    
+    _bootTiming.totalMicros = micros() - initStart;
+
+    LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: Boot %u, %u writes (%.2f%%); init %lu us (store %lu, boot log %lu, wear log %lu, commit %lu%s)",
+             static_cast<unsigned>(_bootCount), static_cast<unsigned>(_flashWriteCount), getWearPercentage(),
+             _bootTiming.totalMicros, _bootTiming.storeMicros, _bootTiming.bootScanMicros,
+             _bootTiming.wearScanMicros, _bootTiming.commitMicros, _bootCommitPending ? " deferred" : "");
+
     _flashWearInitialized = true;
     _lastReportTime = millis();
     return true;
@@ -182,7 +301,8 @@ bool initFlashWearCounter(uint32_t maxWrites, uint16_t counterAddress, uint16_t
 /**
  * Update the flash wear counter after a successful write operation
  */
-bool updateFlashWearCounter() {
+bool flashWearCounter::update(size_t bytesWritten, size_t blockSize) {
+    scopedLock guard(this);
     if (!_flashWearInitialized) {
         LOG_CRITICAL(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Not initialized!");
         return false;
@@ -190,85 +310,422 @@ bool updateFlashWearCounter() {
     
     const uint32_t previousCount = _flashWriteCount;
     _flashWriteCount++;
-    // TODO-FLASHWEAR-2025-11-07: Changed from LOG_INFO to Serial.printf for always-visible output
-    // Flash wear tracking must ALWAYS be visible, not subject to log level filtering
-    // OLD: LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: update request %u -> %u\n", ...);
-    // Gate for deletion: After confirming counter increments correctly with Serial output
-    LOG_INFO(LOG_CAT_SYSTEM,
-             "FlashWearCounter: update request %u -> %u",
-             static_cast<unsigned>(previousCount),
-             static_cast<unsigned>(_flashWriteCount));
-    
-    // Store updated count in EEPROM
-    FlashWearRecord counterRecord;
-    counterRecord.value = _flashWriteCount;
-    counterRecord.valid = FLASH_WEAR_VALID;
-    counterRecord.reserved[0] = 0;
-    counterRecord.reserved[1] = 0;
-    counterRecord.reserved[2] = 0;
-    
-    bool writeSuccess = _writeFlashWearRecord(_counterAddress, &counterRecord, "FlashWearCounter");
-    
-    if (!writeSuccess) {
-        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Failed to write counter to EEPROM!");
-        _flashWriteCount--; // Rollback the increment
-        LOG_INFO(LOG_CAT_SYSTEM,
-                 "FlashWearCounter: update rollback to %u",
-                 static_cast<unsigned>(_flashWriteCount));
-        return false;
+    _bytesWritten += bytesWritten;
+    _sectorsErased += estimateSectors(bytesWritten, blockSize);
+    if (_pendingIncrements == 0) {
+        _firstPendingTime = millis();
+    }
+    _pendingIncrements++;
+    sampleWriteRate();
+
+    bool writeSuccess = true;
+    if (_pendingIncrements >= _commitEvery ||
+        (_commitWindowMs > 0 && (millis() - _firstPendingTime) >= _commitWindowMs)) {
+        if (_verboseLogging) {
+            LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: update request %u -> %u",
+                     static_cast<unsigned>(previousCount), static_cast<unsigned>(_flashWriteCount));
+        }
+        writeSuccess = commitPending();
+    } else if (_verboseLogging) {
+        LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: %u -> %u (%u pending)",
+                 static_cast<unsigned>(previousCount), static_cast<unsigned>(_flashWriteCount),
+                 static_cast<unsigned>(_pendingIncrements));
     }
     
-    // Check if approaching limit
-    float percentage = (float)_flashWriteCount / _maxFlashWrites * 100.0;
-    if (percentage >= _retirementThreshold) {
-        LOG_CRITICAL(LOG_CAT_SYSTEM, "Flash wear at %.2f%% (%u/%u writes) - Device retirement required!\n", 
+    // Log threshold crossings only (and the level once per boot), not every write
+    const uint8_t level = getWarningLevel();
+    if (level != _reportedWarningLevel) {
+        _reportedWarningLevel = level;
+        const float percentage = getWearPercentage();
+        if (level >= 3) {
+            LOG_CRITICAL(LOG_CAT_SYSTEM, "Flash wear at %.2f%% (%u/%u writes) - Device retirement required!",
+                         percentage, _flashWriteCount, _maxFlashWrites);
+            handleRetirement();
+        } else if (level == 2) {
+            LOG_WARN(LOG_CAT_SYSTEM, "WARNING: Flash wear at %.2f%% (%u/%u writes) - Device retirement recommended",
                      percentage, _flashWriteCount, _maxFlashWrites);
-        handleDeviceRetirement();
-    } else if (percentage >= _criticalThreshold) {
-        LOG_WARN(LOG_CAT_SYSTEM, "WARNING: Flash wear at %.2f%% (%u/%u writes) - Device retirement recommended\n", 
-                 percentage, _flashWriteCount, _maxFlashWrites);
-    } else if (percentage >= _cautionThreshold) {
-        LOG_WARN(LOG_CAT_SYSTEM, "CAUTION: Flash wear at %.2f%% (%u/%u writes)\n", 
-                 percentage, _flashWriteCount, _maxFlashWrites);
+        } else if (level == 1) {
+            LOG_WARN(LOG_CAT_SYSTEM, "CAUTION: Flash wear at %.2f%% (%u/%u writes)",
+                     percentage, _flashWriteCount, _maxFlashWrites);
+        }
     }
     
+    return writeSuccess;
+}
+
+uint32_t flashWearCounter::estimateSectors(size_t bytesWritten, size_t blockSize) {
+    if (blockSize == 0) {
+        blockSize = DEFAULT_FS_BLOCK_SIZE;
+    }
+    return (bytesWritten > 0) ? static_cast<uint32_t>((bytesWritten + blockSize - 1) / blockSize) : 1;
+}
+
+// ---------------------------------------------------------------------------
+// Wear-rate forecasting
+// ---------------------------------------------------------------------------
+
+void flashWearCounter::setRateSmoothing(float alpha, unsigned long sampleMs) {
+    scopedLock guard(this);
+    _rateAlpha = (alpha > 0.0f && alpha <= 1.0f) ? alpha : DEFAULT_WEAR_RATE_ALPHA;
+    _rateSampleMs = (sampleMs > 0) ? sampleMs : DEFAULT_WEAR_RATE_SAMPLE_MS;
+}
+
+/**
+ * Fold the writes since the last sample into the EWMA once an interval has passed
+ */
+void flashWearCounter::sampleWriteRate() {
+    scopedLock guard(this);
+    const unsigned long now = millis();
+    const unsigned long elapsedMs = now - _rateSampleTime;
+    if (elapsedMs < _rateSampleMs) {
+        return;
+    }
+
+    // Accumulate uptime in deltas so millis() wrap-around on device is harmless
+    _uptimeRemainderMs += now - _uptimeMark;
+    _uptimeSeconds += _uptimeRemainderMs / 1000;
+    _uptimeRemainderMs %= 1000;
+    _uptimeMark = now;
+
+    const float sample = (_flashWriteCount - _rateSampleWrites) * 3600000.0f / elapsedMs;
+    if (_writeRateKnown) {
+        const float weight = 1.0f - powf(1.0f - _rateAlpha, (float)elapsedMs / _rateSampleMs);
+        _writeRate += weight * (sample - _writeRate);
+    } else {
+        _writeRate = sample;
+        _writeRateKnown = true;
+    }
+    _rateSampleTime = now;
+    _rateSampleWrites = _flashWriteCount;
+
+    LOG_DEBUG(LOG_CAT_SYSTEM, "FlashWearCounter: Write rate sample %.1f/h, average %.1f/h", sample, _writeRate);
+}
+
+uint32_t flashWearCounter::getUptimeSeconds() const {
+    return _uptimeSeconds + static_cast<uint32_t>((_uptimeRemainderMs + (millis() - _uptimeMark)) / 1000);
+}
+
+/**
+ * Writes left until the wear percentage reaches the given value
+ */
+float flashWearCounter::getWritesToWear(float percentage) const {
+    const float current = getWearPercentage();
+    if (current >= percentage) {
+        return 0.0f;
+    }
+
+    float percentPerWrite;
+    if (_eraseCyclesPerBlock > 0 && _eraseBlockCount > 0) {
+        // Erase-cycle limit: scale writes by the average erases per write so far
+        const float sectorsPerWrite = (_flashWriteCount > 0) ? (float)_sectorsErased / _flashWriteCount : 1.0f;
+        percentPerWrite = sectorsPerWrite / ((float)_eraseCyclesPerBlock * _eraseBlockCount) * 100.0f;
+    } else {
+        if (_maxFlashWrites == 0) {
+            return FLASH_WEAR_FORECAST_UNKNOWN;
+        }
+        percentPerWrite = 100.0f / _maxFlashWrites;
+    }
+    return (percentage - current) / percentPerWrite;
+}
+
+/**
+ * Powered-on hours until the wear percentage reaches the given value at the current rate
+ */
+float flashWearCounter::getHoursToWear(float percentage) const {
+    const float writes = getWritesToWear(percentage);
+    if (writes <= 0.0f) {
+        return writes; // Reached (0) or unknown
+    }
+    if (!_writeRateKnown || _writeRate <= 0.0f) {
+        return FLASH_WEAR_FORECAST_UNKNOWN;
+    }
+    return writes / _writeRate;
+}
+
+flashWearForecast flashWearCounter::getForecast() const {
+    scopedLock guard(this);
+    flashWearForecast forecast;
+    forecast.writesPerHour = _writeRate;
+    forecast.writesPerBoot = (_bootCount > 0) ? (float)_flashWriteCount / _bootCount : 0.0f;
+    forecast.uptimeHours = getUptimeSeconds() / 3600;
+    forecast.hoursToCaution = getHoursToWear(_cautionThreshold);
+    forecast.hoursToCritical = getHoursToWear(_criticalThreshold);
+    forecast.hoursToRetirement = getHoursToWear(_retirementThreshold);
+    return forecast;
+}
+
+// ---------------------------------------------------------------------------
+// Write attribution
+// ---------------------------------------------------------------------------
+
+float flashWearSourceStats::getWritesPerHour(unsigned long nowMs) const {
+    if (writes == 0) {
+        return 0.0f;
+    }
+    unsigned long elapsedMs = nowMs - firstWriteMs;
+    if (elapsedMs < 1000) {
+        elapsedMs = 1000;
+    }
+    return writes * 3600000.0f / elapsedMs;
+}
+
+void flashWearCounter::attribute(const char* domain, const char* path, size_t bytesWritten, size_t blockSize) {
+    scopedLock guard(this);
+    const char* domainName = domain ? domain : "";
+    const char* pathName = path ? path : "";
+
+    flashWearSourceStats* source = nullptr;
+    for (auto& entry : _sources) {
+        if (entry.path == pathName && entry.domain == domainName) {
+            source = &entry;
+            break;
+        }
+    }
+    if (!source && _sources.size() >= DEFAULT_FLASH_WEAR_MAX_SOURCES) {
+        // Table full: sum the rest into the overflow entry (the last slot)
+        source = &_sources.back();
+        if (source->path != "(other)") {
+            source = nullptr;
+        }
+    }
+    if (!source) {
+        flashWearSourceStats entry;
+        const bool overflow = _sources.size() + 1 >= DEFAULT_FLASH_WEAR_MAX_SOURCES;
+        entry.domain = overflow ? "" : domainName;
+        entry.path = overflow ? "(other)" : pathName;
+        entry.writes = 0;
+        entry.bytesWritten = 0;
+        entry.sectorsErased = 0;
+        entry.firstWriteMs = millis();
+        entry.lastWriteMs = entry.firstWriteMs;
+        _sources.push_back(entry);
+        source = &_sources.back();
+    }
+
+    source->writes++;
+    source->bytesWritten += bytesWritten;
+    source->sectorsErased += estimateSectors(bytesWritten, blockSize);
+    source->lastWriteMs = millis();
+}
+
+const flashWearSourceStats* flashWearCounter::findSource(const String& path) const {
+    scopedLock guard(this);
+    for (const auto& entry : _sources) {
+        if (entry.path == path) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+flashWearSourceStats flashWearCounter::getDomainStats(const String& domain) const {
+    scopedLock guard(this);
+    flashWearSourceStats total;
+    total.domain = domain;
+    total.writes = 0;
+    total.bytesWritten = 0;
+    total.sectorsErased = 0;
+    total.firstWriteMs = 0;
+    total.lastWriteMs = 0;
+    for (const auto& entry : _sources) {
+        if (entry.domain != domain) {
+            continue;
+        }
+        if (total.writes == 0 || (long)(entry.firstWriteMs - total.firstWriteMs) < 0) {
+            total.firstWriteMs = entry.firstWriteMs;
+        }
+        if (total.writes == 0 || (long)(entry.lastWriteMs - total.lastWriteMs) > 0) {
+            total.lastWriteMs = entry.lastWriteMs;
+        }
+        total.writes += entry.writes;
+        total.bytesWritten += entry.bytesWritten;
+        total.sectorsErased += entry.sectorsErased;
+    }
+    return total;
+}
+
+const flashWearSourceStats* flashWearCounter::getChattiestSource() const {
+    scopedLock guard(this);
+    const flashWearSourceStats* chattiest = nullptr;
+    for (const auto& entry : _sources) {
+        if (!chattiest || entry.sectorsErased > chattiest->sectorsErased ||
+            (entry.sectorsErased == chattiest->sectorsErased && entry.writes > chattiest->writes)) {
+            chattiest = &entry;
+        }
+    }
+    return chattiest;
+}
+
+void flashWearCounter::resetSources() {
+    scopedLock guard(this);
+    _sources.clear();
+}
+
+String flashWearCounter::getSourcesJson() const {
+    scopedLock guard(this);
+    const unsigned long now = millis();
+    String json = "[";
+    for (size_t i = 0; i < _sources.size(); i++) {
+        const flashWearSourceStats& entry = _sources[i];
+        char buffer[160];
+        snprintf(buffer, sizeof(buffer),
+                 "%s{\"domain\":\"%s\",\"path\":\"%s\",\"writes\":%lu,\"bytes\":%llu,\"sectors\":%lu,\"lastMs\":%lu,\"perHour\":%.1f}",
+                 i ? "," : "", entry.domain.c_str(), entry.path.c_str(),
+                 static_cast<unsigned long>(entry.writes), static_cast<unsigned long long>(entry.bytesWritten),
+                 static_cast<unsigned long>(entry.sectorsErased), static_cast<unsigned long>(entry.lastWriteMs),
+                 entry.getWritesPerHour(now));
+        json += buffer;
+    }
+    json += "]";
+    return json;
+}
+
+/**
+ * Set when pending increments are committed
+ */
+void flashWearCounter::setCommitPolicy(uint16_t commitEvery, unsigned long commitWindowMs) {
+    scopedLock guard(this);
+    _commitEvery = (commitEvery == 0) ? 1 : commitEvery;
+    _commitWindowMs = commitWindowMs;
+
+    if (_commitEvery > 1 || _commitWindowMs > 0) {
+        listForShutdownFlush();
+    }
+}
+
+/**
+ * Leave the boot-time commit to the first flush(), service() or committed update()
+ */
+void flashWearCounter::setBootCommitDeferred(bool deferred) {
+    _bootCommitDeferred = deferred;
+    if (deferred) {
+        listForShutdownFlush();
+    }
+}
+
+void flashWearCounter::listForShutdownFlush() {
+    if (!_flushOnShutdownListed) {
+        _nextFlushOnShutdown = _flushOnShutdownList;
+        _flushOnShutdownList = this;
+        _flushOnShutdownListed = true;
+    }
+
+#if defined(ESP32)
+    static bool shutdownHookRegistered = false;
+    if (!shutdownHookRegistered && _flushOnShutdownListed) {
+        // Runs on esp_restart(), including ESP.restart() and OTA reboots
+        shutdownHookRegistered = (esp_register_shutdown_handler(_flushOnShutdown) == ESP_OK);
+    }
+#endif
+}
+
+/**
+ * Flush every counter with deferred commits enabled
+ */
+void flashWearCounter::flushAll() {
+    for (flashWearCounter* counter = _flushOnShutdownList; counter; counter = counter->_nextFlushOnShutdown) {
+        counter->flush();
+    }
+}
+
+/**
+ * Commit pending increments now
+ */
+bool flashWearCounter::flush() {
+    scopedLock guard(this);
+    if (!_flashWearInitialized) {
+        return true;
+    }
+    if (_pendingIncrements > 0) {
+        return commitPending(); // Also carries a pending boot commit
+    }
+    if (_bootCommitPending) {
+        if (!_store->commit()) {
+            LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Deferred boot commit failed");
+            return false;
+        }
+        _bootCommitPending = false;
+    }
     return true;
 }
 
+/**
+ * Commit pending increments once the time window has elapsed
+ */
+bool flashWearCounter::service() {
+    scopedLock guard(this);
+    if (_flashWearInitialized) {
+        sampleWriteRate();
+    }
+    if (_bootCommitPending) {
+        return flush();
+    }
+    if (_pendingIncrements == 0 || _commitWindowMs == 0 ||
+        (millis() - _firstPendingTime) < _commitWindowMs) {
+        return true;
+    }
+    return flush();
+}
+
+uint16_t flashWearCounter::getPendingIncrements() const {
+    return _pendingIncrements;
+}
+
+uint32_t flashWearCounter::getCommitCount() const {
+    return _commitCount;
+}
+
+uint32_t flashWearCounter::getCommitsAvoided() const {
+    return _commitsAvoided;
+}
+
 /**
  * Get the current number of flash writes performed
  */
-uint32_t getFlashWriteCount() {
+uint32_t flashWearCounter::getWriteCount() const {
     return _flashWriteCount;
 }
 
 /**
  * Get the current flash wear percentage
  */
-float getFlashWearPercentage() {
+float flashWearCounter::getWearPercentage() const {
+    if (_eraseCyclesPerBlock > 0 && _eraseBlockCount > 0) {
+        return getEraseCyclesPerBlock() / _eraseCyclesPerBlock * 100.0;
+    }
     if (_maxFlashWrites == 0) return 0.0;
     return (float)_flashWriteCount / _maxFlashWrites * 100.0;
 }
 
 /**
- * Get the maximum number of writes before retirement
+ * Express the retirement limit in erase cycles
  */
-uint32_t getMaxFlashWrites() {
-    return _maxFlashWrites;
+void flashWearCounter::setEraseCycleLimit(uint32_t cyclesPerBlock, uint32_t blockCount) {
+    scopedLock guard(this);
+    _eraseCyclesPerBlock = cyclesPerBlock;
+    _eraseBlockCount = blockCount;
 }
 
-uint32_t getFlashWearCount() {
-    return getFlashWriteCount();
+/**
+ * Average estimated erase count per filesystem block
+ */
+float flashWearCounter::getEraseCyclesPerBlock() const {
+    if (_eraseBlockCount == 0) return 0.0;
+    return (float)_sectorsErased / _eraseBlockCount;
 }
 
-uint32_t getMaxFlashWearCount() {
-    return getMaxFlashWrites();
+/**
+ * Get the maximum number of writes before retirement
+ */
+uint32_t flashWearCounter::getMaxWrites() const {
+    return _maxFlashWrites;
 }
 
 /**
  * Report comprehensive flash wear status
  */
-bool reportFlashWearStatus(bool forceReport) {
+bool flashWearCounter::reportStatus(bool forceReport) {
+    scopedLock guard(this);
     if (!_flashWearInitialized) {
         LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Not initialized!");
         return false;
@@ -279,12 +736,32 @@ bool reportFlashWearStatus(bool forceReport) {
         return false; // Too soon to report again
     }
     
-    float percentage = getFlashWearPercentage();
+    float percentage = getWearPercentage();
     uint8_t warningLevel = getWarningLevel();
     
     LOG_INFO(LOG_CAT_SYSTEM, "Flash Wear Status: %u/%u writes (%.2f%% used)", 
                  _flashWriteCount, _maxFlashWrites, percentage);
+    LOG_INFO(LOG_CAT_SYSTEM, "Flash Wear Accounting: %llu bytes written, %u sectors erased (est.)",
+                 static_cast<unsigned long long>(_bytesWritten), static_cast<unsigned>(_sectorsErased));
+    if (_eraseBlockCount > 0) {
+        LOG_INFO(LOG_CAT_SYSTEM, "Flash Erase Cycles: %.1f/%u per block (%u blocks)",
+                 getEraseCyclesPerBlock(), static_cast<unsigned>(_eraseCyclesPerBlock), static_cast<unsigned>(_eraseBlockCount));
+    }
     LOG_INFO(LOG_CAT_SYSTEM, "Boot Counter: %u boots", static_cast<unsigned>(_bootCount));
+    const flashWearForecast forecast = getForecast();
+    if (forecast.hoursToRetirement != FLASH_WEAR_FORECAST_UNKNOWN) {
+        LOG_INFO(LOG_CAT_SYSTEM, "Flash Wear Forecast: %.1f writes/h, %.1f writes/boot, %u h uptime; caution in %.0f h, critical in %.0f h, retirement in %.0f h",
+                 forecast.writesPerHour, forecast.writesPerBoot, static_cast<unsigned>(forecast.uptimeHours),
+                 forecast.hoursToCaution, forecast.hoursToCritical, forecast.hoursToRetirement);
+    } else {
+        LOG_INFO(LOG_CAT_SYSTEM, "Flash Wear Forecast: no write rate yet (%u h uptime)",
+                 static_cast<unsigned>(forecast.uptimeHours));
+    }
+    if (_commitEvery > 1 || _commitWindowMs > 0) {
+        LOG_INFO(LOG_CAT_SYSTEM, "Flash Wear Commits: %u committed, %u avoided, %u pending",
+                 static_cast<unsigned>(_commitCount), static_cast<unsigned>(_commitsAvoided),
+                 static_cast<unsigned>(_pendingIncrements));
+    }
     
     switch (warningLevel) {
         case 0:
@@ -308,7 +785,8 @@ bool reportFlashWearStatus(bool forceReport) {
 /**
  * Handle device retirement when write limit exceeded
  */
-void handleDeviceRetirement() {
+void flashWearCounter::handleRetirement() {
+    scopedLock guard(this);
     _deviceRetired = true;
     LOG_CRITICAL(LOG_CAT_SYSTEM, "DEVICE RETIREMENT: Flash wear limit exceeded!");
     LOG_CRITICAL(LOG_CAT_SYSTEM, "This device should be replaced immediately!");
@@ -318,14 +796,14 @@ void handleDeviceRetirement() {
 /**
  * Check if device is in retirement mode
  */
-bool isDeviceRetired() {
+bool flashWearCounter::isRetired() const {
     return _deviceRetired;
 }
 
 /**
  * Set custom warning thresholds
  */
-void setWarningThresholds(float caution, float critical, float retirement) {
+void flashWearCounter::setWarningThresholds(float caution, float critical, float retirement) {
     _cautionThreshold = caution;
     _criticalThreshold = critical;
     _retirementThreshold = retirement;
@@ -334,21 +812,23 @@ void setWarningThresholds(float caution, float critical, float retirement) {
 /**
  * Set the periodic report interval
  */
-void setReportInterval(unsigned long intervalMs) {
+void flashWearCounter::setReportInterval(unsigned long intervalMs) {
     _reportInterval = intervalMs;
 }
 
 /**
  * Force an immediate status report
  */
-bool forceStatusReport() {
-    return reportFlashWearStatus(true);
+bool flashWearCounter::forceStatusReport() {
+    scopedLock guard(this);
+    return reportStatus(true);
 }
 
 /**
  * Reset the flash wear counter (use with caution)
  */
-bool resetFlashWearCounter() {
+bool flashWearCounter::reset() {
+    scopedLock guard(this);
     LOG_CRITICAL(LOG_CAT_SYSTEM, "FlashWearCounter: CRITICAL - Bad Programmer! - you can't reset that!");
     return false;
 
@@ -361,14 +841,10 @@ bool resetFlashWearCounter() {
     _flashWriteCount = 0;
     _deviceRetired = false;
 
-    FlashWearRecord resetRecord{};
-    resetRecord.value = _flashWriteCount;
-    resetRecord.valid = FLASH_WEAR_VALID;
-    resetRecord.reserved[0] = 0;
-    resetRecord.reserved[1] = 0;
-    resetRecord.reserved[2] = 0;
-
-    if (!_writeFlashWearRecord(_counterAddress, &resetRecord, "FlashWearCounter")) {
+    _bytesWritten = 0;
+    _sectorsErased = 0;
+    _pendingIncrements = 0;
+    if (!writeWearRecord()) {
         LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Failed to reset wear counter record");
         return false;
     }
@@ -379,32 +855,51 @@ bool resetFlashWearCounter() {
 /**
  * Get flash wear status as a formatted string
  */
-String getFlashWearStatusString() {
+String flashWearCounter::getStatusString() const {
+    scopedLock guard(this);
     if (!_flashWearInitialized) {
         return "FlashWearCounter: Not initialized";
     }
     
-    float percentage = getFlashWearPercentage();
-    uint8_t warningLevel = getWarningLevel();
-    
-    String status = "Flash Wear: " + String(_flashWriteCount) + "/" + String(_maxFlashWrites) + 
-                   " (" + String(percentage, 2) + "%)";
-    status += " | Boots: " + String(_bootCount);
-    
-    switch (warningLevel) {
-        case 1: status += " [CAUTION]"; break;
-        case 2: status += " [WARNING]"; break;
-        case 3: status += " [CRITICAL]"; break;
+    static const char* const levelTags[] = {"", " [CAUTION]", " [WARNING]", " [CRITICAL]"};
+    const uint8_t warningLevel = getWarningLevel();
+    char status[128];
+    snprintf(status, sizeof(status), "Flash Wear: %lu/%lu (%.2f%%) | Erases: %lu | Rate: %.1f/h | Boots: %lu%s",
+             static_cast<unsigned long>(_flashWriteCount), static_cast<unsigned long>(_maxFlashWrites),
+             getWearPercentage(), static_cast<unsigned long>(_sectorsErased), _writeRate,
+             static_cast<unsigned long>(_bootCount), levelTags[warningLevel < 4 ? warningLevel : 3]);
+    return String(status);
+}
+
+/**
+ * Fill a telemetry snapshot; no formatting, no allocation
+ */
+void flashWearCounter::getTelemetry(flashWearTelemetry* out) const {
+    scopedLock guard(this);
+    if (!out) {
+        return;
     }
-    
-    return status;
+    const float percentage = getWearPercentage();
+    out->writeCount = _flashWriteCount;
+    out->maxWrites = _maxFlashWrites;
+    out->bytesWritten = _bytesWritten;
+    out->sectorsErased = _sectorsErased;
+    out->bootCount = _bootCount;
+    out->commitCount = _commitCount;
+    out->writesPerHour = _writeRate;
+    out->wearCentiPercent = static_cast<uint16_t>(percentage >= 655.35f ? 65535 : percentage * 100.0f + 0.5f);
+    out->pendingIncrements = _pendingIncrements;
+    out->warningLevel = getWarningLevel();
+    out->flags = static_cast<uint8_t>((_flashWearInitialized ? FLASH_WEAR_TELEMETRY_INITIALIZED : 0) |
+                                      (_deviceRetired ? FLASH_WEAR_TELEMETRY_RETIRED : 0) |
+                                      (_bootCommitPending ? FLASH_WEAR_TELEMETRY_BOOT_PENDING : 0));
 }
 
 /**
  * Check if a warning should be issued based on current wear level
  */
-uint8_t getWarningLevel() {
-    float percentage = getFlashWearPercentage();
+uint8_t flashWearCounter::getWarningLevel() const {
+    float percentage = getWearPercentage();
     
     if (percentage >= _retirementThreshold) return 3; // Retirement
     if (percentage >= _criticalThreshold) return 2;   // Critical
@@ -412,24 +907,19 @@ uint8_t getWarningLevel() {
     return 0; // Normal
 }
 
-uint32_t getBootCount() {
+uint32_t flashWearCounter::getBootCount() const {
     return _bootCount;
 }
 
-bool resetBootCounter() {
+bool flashWearCounter::resetBootCounter() {
+    scopedLock guard(this);
     if (!_bootCounterInitialized) {
         LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Not initialized!");
         return false;
     }
 
-    FlashWearRecord resetRecord{};
-    resetRecord.value = 0;
-    resetRecord.valid = FLASH_WEAR_VALID;
-    resetRecord.reserved[0] = 0;
-    resetRecord.reserved[1] = 0;
-    resetRecord.reserved[2] = 0;
-
-    if (!_writeFlashWearRecord(_bootCounterAddress, &resetRecord, "BootCounter")) {
+    const uint32_t zero = 0;
+    if (!appendLog(&_bootLog, &zero, "BootCounter")) {
         LOG_ERROR(LOG_CAT_SYSTEM, "BootCounter: ERROR - Failed to reset boot counter record");
         return false;
     }
@@ -439,7 +929,7 @@ bool resetBootCounter() {
     return true;
 }
 
-String getBootCounterStatusString() {
+String flashWearCounter::getBootCounterStatusString() const {
     if (!_bootCounterInitialized) {
         return "BootCounter: Not initialized";
     }
@@ -449,54 +939,339 @@ String getBootCounterStatusString() {
 
 // Private helper functions
 
-/**
- * Initialize EEPROM for the platform
- */
-static void _initializeEEPROM() {
-#if defined(ESP32)
-    EEPROM.begin(512); // ESP32 needs explicit size
-    LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: EEPROM initialized with 512 bytes for ESP32");
-#elif defined(ESP8266)
-    EEPROM.begin(512); // ESP8266 needs explicit size
-    LOG_INFO(LOG_CAT_SYSTEM, "FlashWearCounter: EEPROM initialized with 512 bytes for ESP8266");
-#endif
-}
-
 /**
  * Read flash wear record from EEPROM
  */
-static bool _readFlashWearRecord(uint16_t address, FlashWearRecord* record) {
+bool flashWearCounter::readLegacyRecord(uint16_t address, FlashWearRecord* record) {
     if (!record) return false;
 
     uint8_t* data = reinterpret_cast<uint8_t*>(record);
     for (uint8_t i = 0; i < FLASH_WEAR_RECORD_SIZE; i++) {
-        data[i] = EEPROM.read(address + i);
+        data[i] = _store->read(address + i);
     }
 
     return true;
 }
 
-static bool _writeFlashWearRecord(uint16_t address, const FlashWearRecord* record, const char* label) {
-    if (!record) return false;
+/**
+ * Append the in-RAM totals to the wear ring
+ */
+bool flashWearCounter::writeWearRecord(bool commit) {
+    uint32_t values[FLASH_WEAR_LOG_VALUES];
+    values[WEAR_VALUE_WRITES] = _flashWriteCount;
+    values[WEAR_VALUE_SECTORS] = _sectorsErased;
+    values[WEAR_VALUE_BYTES_LOW] = static_cast<uint32_t>(_bytesWritten);
+    values[WEAR_VALUE_BYTES_HIGH] = static_cast<uint32_t>(_bytesWritten >> 32);
+    values[WEAR_VALUE_UPTIME] = getUptimeSeconds();
+    memcpy(&values[WEAR_VALUE_RATE], &_writeRate, sizeof(_writeRate));
+    return appendLog(&_wearLog, values, "FlashWearCounter", commit);
+}
 
+/**
+ * Write the in-RAM count covering all pending increments
+ */
+bool flashWearCounter::commitPending() {
+    if (!writeWearRecord()) {
+        // The config writes did happen: keep them pending and retry on the next commit
+        LOG_ERROR(LOG_CAT_SYSTEM, "FlashWearCounter: ERROR - Failed to write counter to EEPROM! %u increments pending",
+                  static_cast<unsigned>(_pendingIncrements));
+        return false;
+    }
+    _commitCount++;
+    if (_pendingIncrements > 1) {
+        _commitsAvoided += _pendingIncrements - 1;
+    }
+    _pendingIncrements = 0;
+    return true;
+}
+
+#if defined(ESP32)
+static void _flushOnShutdown() {
+    flashWearCounter::flushAll();
+}
+#endif
+
+/**
+ * CRC-8 (polynomial 0x07, initial value 0xFF) over values, sequence and marker
+ */
+uint8_t flashWearCounter::logCrc(const uint8_t* record, uint8_t length) {
+    uint8_t crc = 0xFF;
+    for (uint8_t i = 0; i < length; i++) {
+        crc ^= record[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = static_cast<uint8_t>((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * Find the newest valid record of a ring
+ * @return false if the ring holds no valid record
+ */
+bool flashWearCounter::scanLog(logRing* ring, uint32_t* values) {
+    ring->empty = true;
+    const uint16_t size = recordSize(ring);
+    const uint8_t payload = static_cast<uint8_t>(ring->values * 4 + 2); // Values + sequence
+    uint8_t data[FLASH_WEAR_LOG_MAX_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE];
+
+    for (uint16_t slot = 0; slot < ring->slots; slot++) {
+        const uint16_t address = static_cast<uint16_t>(ring->address + slot * size);
+        for (uint16_t i = 0; i < size; i++) {
+            data[i] = _store->read(address + i);
+        }
+        if (data[payload] != FLASH_WEAR_LOG_VALID ||
+            data[payload + 1] != logCrc(data, static_cast<uint8_t>(payload + 1))) {
+            continue;
+        }
+        const uint16_t sequence = static_cast<uint16_t>(data[payload - 2] | (data[payload - 1] << 8));
+        // Serial-number comparison: newer even after the 16-bit sequence wraps
+        if (ring->empty || static_cast<int16_t>(sequence - ring->sequence) > 0) {
+            ring->empty = false;
+            ring->head = slot;
+            ring->sequence = sequence;
+            for (uint8_t v = 0; v < ring->values; v++) {
+                const uint8_t* p = data + v * 4;
+                values[v] = static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+                            (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+            }
+        }
+    }
+    return !ring->empty;
+}
+
+/**
+ * Write a record to the slot after the newest one and commit (or only stage it)
+ */
+bool flashWearCounter::appendLog(logRing* ring, const uint32_t* values, const char* label, bool commit) {
     const char* prefix = (label && label[0] != '\0') ? label : "FlashWearCounter";
 
-    LOG_INFO(LOG_CAT_SYSTEM, "%s: Writing to EEPROM byte offset %u, value=%u, valid=0x%02X",
-                  prefix, static_cast<unsigned>(address), record->value, record->valid);
+    const uint16_t size = recordSize(ring);
+    const uint16_t slot = ring->empty ? 0 : static_cast<uint16_t>((ring->head + 1) % ring->slots);
+    const uint16_t address = static_cast<uint16_t>(ring->address + slot * size);
+    const uint16_t sequence = ring->empty ? 0 : static_cast<uint16_t>(ring->sequence + 1);
 
-    const uint8_t* data = reinterpret_cast<const uint8_t*>(record);
-    for (uint8_t i = 0; i < FLASH_WEAR_RECORD_SIZE; i++) {
-        EEPROM.write(address + i, data[i]);
+    uint8_t data[FLASH_WEAR_LOG_MAX_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE];
+    uint8_t length = 0;
+    for (uint8_t v = 0; v < ring->values; v++) {
+        data[length++] = static_cast<uint8_t>(values[v]);
+        data[length++] = static_cast<uint8_t>(values[v] >> 8);
+        data[length++] = static_cast<uint8_t>(values[v] >> 16);
+        data[length++] = static_cast<uint8_t>(values[v] >> 24);
     }
+    data[length++] = static_cast<uint8_t>(sequence);
+    data[length++] = static_cast<uint8_t>(sequence >> 8);
+    data[length] = FLASH_WEAR_LOG_VALID;
+    data[length + 1] = logCrc(data, static_cast<uint8_t>(length + 1));
 
-#if defined(ESP32) || defined(ESP8266)
-    bool success = EEPROM.commit(); // Commit the write operation
-    if (!success) {
-        LOG_ERROR(LOG_CAT_SYSTEM, "%s: ERROR - EEPROM commit failed!", prefix);
-        return false;
+    if (_verboseLogging) {
+        LOG_INFO(LOG_CAT_SYSTEM, "%s: Writing to EEPROM log slot %u (byte offset %u), value=%u, sequence=%u",
+                 prefix, static_cast<unsigned>(slot), static_cast<unsigned>(address),
+                 static_cast<unsigned>(values[0]), static_cast<unsigned>(sequence));
+    }
+
+    for (uint16_t i = 0; i < size; i++) {
+        _store->write(address + i, data[i]);
     }
-    LOG_INFO(LOG_CAT_SYSTEM, "%s: EEPROM write committed successfully", prefix);
-#endif
 
+    if (commit) {
+        bool success = _store->commit(); // Commit the write operation
+        if (!success) {
+            LOG_ERROR(LOG_CAT_SYSTEM, "%s: ERROR - EEPROM commit failed!", prefix);
+            return false;
+        }
+        if (_verboseLogging) {
+            LOG_INFO(LOG_CAT_SYSTEM, "%s: EEPROM write committed successfully", prefix);
+        }
+        _bootCommitPending = false; // A commit flushes the whole store
+    }
+
+    ring->head = slot;
+    ring->sequence = sequence;
+    ring->empty = false;
     return true;
-}
\ No newline at end of file
+}
+
+// Process-wide counter behind the free-function API
+
+flashWearCounter& defaultFlashWearCounter() {
+#ifdef CONFIGMGR_NATIVE
+    static ramByteStore store;
+#else
+    static eepromByteStore store;
+#endif
+    static flashWearCounter counter(&store);
+    return counter;
+}
+
+bool setFlashWearLogRegion(uint16_t address, uint16_t length, uint16_t bootSlots) {
+    return defaultFlashWearCounter().setLogRegion(address, length, bootSlots);
+}
+
+bool initFlashWearCounter(uint32_t maxWrites, uint16_t counterAddress, uint16_t bootCounterAddress) {
+    return defaultFlashWearCounter().begin(maxWrites, counterAddress, bootCounterAddress);
+}
+
+bool updateFlashWearCounter(size_t bytesWritten, size_t blockSize) {
+    return defaultFlashWearCounter().update(bytesWritten, blockSize);
+}
+
+void setEraseCycleLimit(uint32_t cyclesPerBlock, uint32_t blockCount) {
+    defaultFlashWearCounter().setEraseCycleLimit(cyclesPerBlock, blockCount);
+}
+
+uint64_t getFlashBytesWritten() {
+    return defaultFlashWearCounter().getBytesWritten();
+}
+
+uint32_t getFlashSectorsErased() {
+    return defaultFlashWearCounter().getSectorsErased();
+}
+
+float getFlashEraseCyclesPerBlock() {
+    return defaultFlashWearCounter().getEraseCyclesPerBlock();
+}
+
+void getFlashWearTelemetry(flashWearTelemetry* out) {
+    defaultFlashWearCounter().getTelemetry(out);
+}
+
+void setFlashWearVerboseLogging(bool verbose) {
+    defaultFlashWearCounter().setVerboseLogging(verbose);
+}
+
+void setFlashWearBootCommitDeferred(bool deferred) {
+    defaultFlashWearCounter().setBootCommitDeferred(deferred);
+}
+
+const flashWearBootTiming& getFlashWearBootTiming() {
+    return defaultFlashWearCounter().getBootTiming();
+}
+
+void setWearRateSmoothing(float alpha, unsigned long sampleMs) {
+    defaultFlashWearCounter().setRateSmoothing(alpha, sampleMs);
+}
+
+float getFlashWriteRate() {
+    return defaultFlashWearCounter().getWriteRatePerHour();
+}
+
+flashWearForecast getFlashWearForecast() {
+    return defaultFlashWearCounter().getForecast();
+}
+
+void attributeFlashWrite(const char* domain, const char* path, size_t bytesWritten, size_t blockSize) {
+    defaultFlashWearCounter().attribute(domain, path, bytesWritten, blockSize);
+}
+
+const std::vector<flashWearSourceStats>& getFlashWearSources() {
+    return defaultFlashWearCounter().getSources();
+}
+
+flashWearSourceStats getFlashWearDomainStats(const String& domain) {
+    return defaultFlashWearCounter().getDomainStats(domain);
+}
+
+const flashWearSourceStats* getChattiestFlashWriter() {
+    return defaultFlashWearCounter().getChattiestSource();
+}
+
+String getFlashWearSourcesJson() {
+    return defaultFlashWearCounter().getSourcesJson();
+}
+
+void resetFlashWearSources() {
+    defaultFlashWearCounter().resetSources();
+}
+
+void setFlashWearCommitPolicy(uint16_t commitEvery, unsigned long commitWindowMs) {
+    defaultFlashWearCounter().setCommitPolicy(commitEvery, commitWindowMs);
+}
+
+bool flushFlashWearCounter() {
+    return defaultFlashWearCounter().flush();
+}
+
+bool serviceFlashWearCounter() {
+    return defaultFlashWearCounter().service();
+}
+
+uint16_t getFlashWearPendingIncrements() {
+    return defaultFlashWearCounter().getPendingIncrements();
+}
+
+uint32_t getFlashWearCommitCount() {
+    return defaultFlashWearCounter().getCommitCount();
+}
+
+uint32_t getFlashWearCommitsAvoided() {
+    return defaultFlashWearCounter().getCommitsAvoided();
+}
+
+uint32_t getFlashWriteCount() {
+    return defaultFlashWearCounter().getWriteCount();
+}
+
+float getFlashWearPercentage() {
+    return defaultFlashWearCounter().getWearPercentage();
+}
+
+uint32_t getMaxFlashWrites() {
+    return defaultFlashWearCounter().getMaxWrites();
+}
+
+uint32_t getFlashWearCount() {
+    return getFlashWriteCount();
+}
+
+uint32_t getMaxFlashWearCount() {
+    return getMaxFlashWrites();
+}
+
+bool reportFlashWearStatus(bool forceReport) {
+    return defaultFlashWearCounter().reportStatus(forceReport);
+}
+
+void handleDeviceRetirement() {
+    defaultFlashWearCounter().handleRetirement();
+}
+
+bool isDeviceRetired() {
+    return defaultFlashWearCounter().isRetired();
+}
+
+void setWarningThresholds(float caution, float critical, float retirement) {
+    defaultFlashWearCounter().setWarningThresholds(caution, critical, retirement);
+}
+
+void setReportInterval(unsigned long intervalMs) {
+    defaultFlashWearCounter().setReportInterval(intervalMs);
+}
+
+bool forceStatusReport() {
+    return defaultFlashWearCounter().forceStatusReport();
+}
+
+bool resetFlashWearCounter() {
+    return defaultFlashWearCounter().reset();
+}
+
+String getFlashWearStatusString() {
+    return defaultFlashWearCounter().getStatusString();
+}
+
+uint8_t getWarningLevel() {
+    return defaultFlashWearCounter().getWarningLevel();
+}
+
+uint32_t getBootCount() {
+    return defaultFlashWearCounter().getBootCount();
+}
+
+bool resetBootCounter() {
+    return defaultFlashWearCounter().resetBootCounter();
+}
+
+String getBootCounterStatusString() {
+    return defaultFlashWearCounter().getBootCounterStatusString();
+}
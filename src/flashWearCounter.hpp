@@ -1,6 +1,16 @@
 #pragma once
 
 #include <Arduino.h>
+#include <interface/iByteStore.hpp>
+#include <interface/iFileSystemProvider.hpp>
+#include <vector>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#elif defined(CONFIGMGR_NATIVE)
+#include <mutex>
+#endif
 
 /**
  * Flash Wear Counter Library
@@ -9,14 +19,17 @@
  * for any device using the config libraries. Tracks flash write operations
  * and manages device retirement based on configurable limits.
  * 
- * This library is completely self-contained and handles its own EEPROM operations
- * without depending on external EEPROM libraries.
+ * The counter logic lives in class flashWearCounter, which persists through
+ * an iByteStore: the Arduino EEPROM emulation on device, a RAM or file backed
+ * store on native builds. The free functions below operate on a process-wide
+ * instance (defaultFlashWearCounter()) and are what configManager uses.
  */
 
 // Configuration constants
 const uint32_t DEFAULT_MAX_FLASH_WRITES = 12000000; // 12 million writes
 const uint16_t DEFAULT_FLASH_WEAR_COUNTER_ADDRESS = 255; // Byte offset near end of 512-byte EEPROM emulation
 const unsigned long DEFAULT_REPORT_INTERVAL_MS = 300000; // 5 minutes
+const uint16_t FLASH_WEAR_EEPROM_SIZE = 512; // Bytes requested from the byte store
 
 // Warning thresholds (percentages)
 const float CAUTION_THRESHOLD = 75.0;
@@ -30,16 +43,356 @@ struct FlashWearRecord {
     uint8_t reserved[3]; // Padding to make it 8 bytes
 };
 
+/**
+ * Ring-buffer log records
+ *
+ * Both counters are stored as a rotating log: every update appends a record
+ * with the next sequence number to the following slot of its ring instead of
+ * rewriting one fixed location, so writes are spread over the whole region
+ * and the previous records stay in place as redundant copies. At init the
+ * ring is scanned and the CRC-valid record with the highest sequence
+ * (serial-number arithmetic, so wrap-around is handled) is the current
+ * value; a torn or corrupted newest record falls back to the one before it
+ * without any extra commit. The scan reads the EEPROM emulation's RAM
+ * mirror, not the flash.
+ *
+ * Record layout, little-endian: N uint32_t values, uint16_t sequence,
+ * uint8_t FLASH_WEAR_LOG_VALID, uint8_t CRC-8 over everything before it.
+ * Boot records hold the boot count (8 bytes). Wear records hold the write
+ * count, estimated sectors erased, the 64-bit byte count, the powered-on
+ * seconds over all boots and the smoothed write rate (28 bytes).
+ */
+const uint8_t FLASH_WEAR_LOG_TRAILER_SIZE = 4;
+const uint8_t BOOT_COUNTER_LOG_VALUES = 1;
+const uint8_t FLASH_WEAR_LOG_VALUES = 6;
+const uint8_t FLASH_WEAR_LOG_MAX_VALUES = 6;
+
 // EEPROM constants
-const uint8_t FLASH_WEAR_VALID = 0xAA;
+const uint8_t FLASH_WEAR_VALID = 0xAA;      // Legacy records
+const uint8_t FLASH_WEAR_LOG_VALID = 0xA5;  // CRC-8 protected log records
 const uint8_t FLASH_WEAR_RECORD_SIZE = 8;
 const uint16_t DEFAULT_BOOT_COUNTER_ADDRESS = DEFAULT_FLASH_WEAR_COUNTER_ADDRESS - FLASH_WEAR_RECORD_SIZE; // Store boot counter just before wear record
 const uint32_t BOOT_COUNTER_SANITY_LIMIT = 1000000; // Guard against corrupted counts
 
+// Log region: everything after the legacy records in the 512-byte EEPROM emulation
+const uint16_t DEFAULT_FLASH_WEAR_LOG_ADDRESS = DEFAULT_FLASH_WEAR_COUNTER_ADDRESS + FLASH_WEAR_RECORD_SIZE + 1; // 264
+const uint16_t DEFAULT_FLASH_WEAR_LOG_LENGTH = FLASH_WEAR_EEPROM_SIZE - DEFAULT_FLASH_WEAR_LOG_ADDRESS;        // 248 bytes
+const uint16_t DEFAULT_BOOT_COUNTER_LOG_SLOTS = 7;   // 56 bytes; the remaining 192 hold 6 wear records
+
+// Wear-rate forecasting
+const unsigned long DEFAULT_WEAR_RATE_SAMPLE_MS = 600000; // 10 minutes per write-rate sample
+const float DEFAULT_WEAR_RATE_ALPHA = 0.2f;               // EWMA weight of one sample interval
+const float FLASH_WEAR_FORECAST_UNKNOWN = -1.0f;          // No write rate observed yet
+
+// Write attribution
+const uint8_t DEFAULT_FLASH_WEAR_MAX_SOURCES = 16;   // Attribution entries; the last one, "(other)", sums pairs that did not fit
+
+// Deferred commits (default: commit every increment, as before)
+const uint16_t DEFAULT_FLASH_WEAR_COMMIT_EVERY = 1;
+const unsigned long DEFAULT_FLASH_WEAR_COMMIT_WINDOW_MS = 0; // 0 = no time-based commit
+
+/**
+ * Write rate and projected time until each wear threshold
+ *
+ * Hours are powered-on hours at the current rate: 0 once the threshold is
+ * reached, FLASH_WEAR_FORECAST_UNKNOWN while no rate is known (or the rate is 0).
+ */
+struct flashWearForecast {
+    float writesPerHour;        // EWMA over uptime, carried across boots
+    float writesPerBoot;        // Lifetime average
+    uint32_t uptimeHours;       // Powered-on hours over all boots
+    float hoursToCaution;
+    float hoursToCritical;
+    float hoursToRetirement;
+};
+
+/**
+ * Compact wear and boot telemetry snapshot
+ *
+ * Plain data for periodic telemetry (MQTT, ESP-NOW, a web endpoint):
+ * filled by a handful of copies, unlike getFlashWearStatusString().
+ */
+const uint8_t FLASH_WEAR_TELEMETRY_INITIALIZED = 0x01;
+const uint8_t FLASH_WEAR_TELEMETRY_RETIRED = 0x02;
+const uint8_t FLASH_WEAR_TELEMETRY_BOOT_PENDING = 0x04;
+
+struct flashWearTelemetry {
+    uint64_t bytesWritten;
+    uint32_t writeCount;
+    uint32_t maxWrites;
+    uint32_t sectorsErased;
+    uint32_t bootCount;
+    uint32_t commitCount;       // Wear counter commits this boot
+    float writesPerHour;        // Smoothed write rate
+    uint16_t wearCentiPercent;  // Wear percentage in 0.01 % units
+    uint16_t pendingIncrements;
+    uint8_t warningLevel;       // 0=none, 1=caution, 2=critical, 3=retirement
+    uint8_t flags;              // FLASH_WEAR_TELEMETRY_*
+};
+
+/**
+ * Where begin() spent its time, in microseconds
+ */
+struct flashWearBootTiming {
+    unsigned long storeMicros;      // Byte store begin (EEPROM.begin() copies the sector to RAM)
+    unsigned long bootScanMicros;   // Boot ring scan and staged increment
+    unsigned long wearScanMicros;   // Wear ring scan (or legacy migration)
+    unsigned long commitMicros;     // The single boot commit, 0 when deferred
+    unsigned long totalMicros;
+    uint8_t commits;                // 1, or 0 with setBootCommitDeferred()
+};
+
+/**
+ * Writes attributed to one domain/path pair since boot (RAM only)
+ */
+struct flashWearSourceStats {
+    String domain;              // configManager::getDomain(), empty if unregistered
+    String path;                // File written
+    uint32_t writes;
+    uint64_t bytesWritten;
+    uint32_t sectorsErased;     // Estimated as in updateFlashWearCounter()
+    unsigned long firstWriteMs;
+    unsigned long lastWriteMs;
+
+    // Average since the first write (one write counts over at least one second)
+    float getWritesPerHour(unsigned long nowMs) const;
+};
+
+/**
+ * Flash wear and boot counter over an injectable byte store.
+ *
+ * Methods match the free functions below (begin() is initFlashWearCounter(),
+ * update() is updateFlashWearCounter(), ...). Independent instances on
+ * separate stores can be created, e.g. for native tests and benchmarks:
+ *
+ *   ramByteStore store;
+ *   flashWearCounter counter(&store);
+ *   counter.begin();
+ *   counter.update();
+ */
+class flashWearCounter {
+public:
+    explicit flashWearCounter(iByteStore* store);
+    ~flashWearCounter();
+
+    bool setLogRegion(uint16_t address = DEFAULT_FLASH_WEAR_LOG_ADDRESS,
+                      uint16_t length = DEFAULT_FLASH_WEAR_LOG_LENGTH,
+                      uint16_t bootSlots = DEFAULT_BOOT_COUNTER_LOG_SLOTS);
+    bool begin(uint32_t maxWrites = DEFAULT_MAX_FLASH_WRITES,
+               uint16_t counterAddress = DEFAULT_FLASH_WEAR_COUNTER_ADDRESS,
+               uint16_t bootCounterAddress = DEFAULT_BOOT_COUNTER_ADDRESS);
+    bool isInitialized() const { return _flashWearInitialized; }
+    void setBootCommitDeferred(bool deferred);     // Call before begin()
+    bool isBootCommitPending() const { return _bootCommitPending; }
+    const flashWearBootTiming& getBootTiming() const { return _bootTiming; }
+    bool update(size_t bytesWritten = 0, size_t blockSize = DEFAULT_FS_BLOCK_SIZE);
+
+    // Byte and sector accounting
+    void setEraseCycleLimit(uint32_t cyclesPerBlock, uint32_t blockCount);
+    uint64_t getBytesWritten() const { return _bytesWritten; }
+    uint32_t getSectorsErased() const { return _sectorsErased; }
+    float getEraseCyclesPerBlock() const;
+
+    // Wear-rate forecasting
+    void setRateSmoothing(float alpha = DEFAULT_WEAR_RATE_ALPHA,
+                          unsigned long sampleMs = DEFAULT_WEAR_RATE_SAMPLE_MS);
+    float getWriteRatePerHour() const { return _writeRate; }
+    uint32_t getUptimeSeconds() const;
+    float getWritesToWear(float percentage) const;  // FLASH_WEAR_FORECAST_UNKNOWN without a limit
+    float getHoursToWear(float percentage) const;
+    flashWearForecast getForecast() const;
+
+    // Write attribution. getSources(), findSource() and getChattiestSource()
+    // point into live state; while other tasks save, prefer the copies from
+    // getDomainStats() / getSourcesJson().
+    void attribute(const char* domain, const char* path, size_t bytesWritten,
+                   size_t blockSize = DEFAULT_FS_BLOCK_SIZE);
+    const std::vector<flashWearSourceStats>& getSources() const { return _sources; }
+    const flashWearSourceStats* findSource(const String& path) const;
+    flashWearSourceStats getDomainStats(const String& domain) const;
+    const flashWearSourceStats* getChattiestSource() const;
+    String getSourcesJson() const;
+    void resetSources();
+
+    // Deferred commits
+    void setCommitPolicy(uint16_t commitEvery = DEFAULT_FLASH_WEAR_COMMIT_EVERY,
+                         unsigned long commitWindowMs = DEFAULT_FLASH_WEAR_COMMIT_WINDOW_MS);
+    bool flush();
+    bool service();
+    static void flushAll(); // Every instance with deferred commits enabled
+    uint16_t getPendingIncrements() const;
+    uint32_t getCommitCount() const;
+    uint32_t getCommitsAvoided() const;
+
+    // Wear status
+    uint32_t getWriteCount() const;
+    float getWearPercentage() const;
+    uint32_t getMaxWrites() const;
+    uint8_t getWarningLevel() const;
+    String getStatusString() const;
+    void getTelemetry(flashWearTelemetry* out) const;
+    void setVerboseLogging(bool verbose) { _verboseLogging = verbose; }
+    bool reportStatus(bool forceReport = false);
+    bool forceStatusReport();
+    void handleRetirement();
+    bool isRetired() const;
+    void setWarningThresholds(float caution = CAUTION_THRESHOLD,
+                              float critical = CRITICAL_THRESHOLD,
+                              float retirement = RETIREMENT_THRESHOLD);
+    float getRetirementThreshold() const { return _retirementThreshold; }
+    void setReportInterval(unsigned long intervalMs);
+    bool reset();
+
+    // Boot counter
+    uint32_t getBootCount() const;
+    bool resetBootCounter();
+    String getBootCounterStatusString() const;
+
+private:
+    struct logRing {
+        uint16_t address;   // First byte of the ring
+        uint16_t slots;     // Records in the ring
+        uint8_t values;     // uint32_t values per record
+        uint16_t head;      // Slot holding the newest record
+        uint16_t sequence;  // Sequence number of the newest record
+        bool empty;         // No valid record found yet
+    };
+
+    bool readLegacyRecord(uint16_t address, FlashWearRecord* record);
+    static uint8_t logCrc(const uint8_t* record, uint8_t length);
+    static uint32_t estimateSectors(size_t bytesWritten, size_t blockSize);
+    static uint16_t recordSize(const logRing* ring) { return static_cast<uint16_t>(ring->values * 4 + FLASH_WEAR_LOG_TRAILER_SIZE); }
+    bool scanLog(logRing* ring, uint32_t* values);
+    bool appendLog(logRing* ring, const uint32_t* values, const char* label, bool commit = true);
+    bool writeWearRecord(bool commit = true);
+    void listForShutdownFlush();
+    void sampleWriteRate();
+    bool commitPending();
+
+    iByteStore* _store;
+    uint32_t _maxFlashWrites;
+    uint16_t _counterAddress;
+    uint16_t _bootCounterAddress;
+    uint32_t _flashWriteCount;
+    uint64_t _bytesWritten;
+    uint32_t _sectorsErased;
+    uint32_t _eraseCyclesPerBlock;
+    uint32_t _eraseBlockCount;
+    uint32_t _bootCount;
+    bool _flashWearInitialized;
+    bool _bootCounterInitialized;
+    unsigned long _lastReportTime;
+    unsigned long _reportInterval;
+    bool _deviceRetired;
+    size_t _eepromLength;
+
+    // Warning thresholds
+    float _cautionThreshold;
+    float _criticalThreshold;
+    float _retirementThreshold;
+
+    // Ring-buffer log state
+    uint16_t _logAddress;
+    uint16_t _logLength;
+    uint16_t _bootLogSlots;
+    logRing _wearLog;
+    logRing _bootLog;
+
+    // Deferred commit state
+    uint16_t _commitEvery;
+    unsigned long _commitWindowMs;
+    uint16_t _pendingIncrements;
+    unsigned long _firstPendingTime;
+    uint32_t _commitCount;
+    uint32_t _commitsAvoided;
+
+    // Write-rate EWMA and lifetime uptime
+    uint32_t _uptimeSeconds;        // Up to _uptimeMark
+    unsigned long _uptimeMark;
+    unsigned long _uptimeRemainderMs;
+    float _writeRate;
+    bool _writeRateKnown;
+    float _rateAlpha;
+    unsigned long _rateSampleMs;
+    unsigned long _rateSampleTime;
+    uint32_t _rateSampleWrites;
+
+    // Boot-time commit
+    bool _bootCommitDeferred;
+    bool _bootCommitPending;
+    flashWearBootTiming _bootTiming;
+
+    // Logging
+    uint8_t _reportedWarningLevel;  // Level last logged by update()
+    bool _verboseLogging;
+
+    // Write attribution, in order of first write
+    std::vector<flashWearSourceStats> _sources;
+
+    // Instances flushed by flushAll()
+    static flashWearCounter* _flushOnShutdownList;
+    bool _flushOnShutdownListed;
+    flashWearCounter* _nextFlushOnShutdown;
+
+    // Saves run on the async worker as well as the caller's task: every
+    // entry point that touches counter, log or attribution state holds this
+    // (recursive, as public calls nest). No-op without a threading layer.
+    class scopedLock {
+    public:
+        explicit scopedLock(const flashWearCounter* counter);
+        ~scopedLock();
+    private:
+        scopedLock(const scopedLock&) = delete;
+        scopedLock& operator=(const scopedLock&) = delete;
+        const flashWearCounter* _counter;
+    };
+#if defined(ESP32)
+    SemaphoreHandle_t _mutex;
+#elif defined(CONFIGMGR_NATIVE)
+    mutable std::recursive_mutex _mutex;
+#endif
+};
+
+/**
+ * The instance behind the free-function API (EEPROM on device, RAM on native)
+ */
+flashWearCounter& defaultFlashWearCounter();
+
+/**
+ * Set the EEPROM region used for the counter logs. Call before initFlashWearCounter().
+ * The region is split into a boot counter ring of bootSlots 8-byte records and
+ * a wear counter ring using the remaining whole 28-byte records.
+ * @param address first EEPROM byte of the region (default: 264)
+ * @param length region size in bytes (default: 248)
+ * @param bootSlots records reserved for the boot counter ring (default: 7)
+ * @return true if the region holds at least two records per ring
+ */
+bool setFlashWearLogRegion(uint16_t address = DEFAULT_FLASH_WEAR_LOG_ADDRESS,
+                           uint16_t length = DEFAULT_FLASH_WEAR_LOG_LENGTH,
+                           uint16_t bootSlots = DEFAULT_BOOT_COUNTER_LOG_SLOTS);
+
+/**
+ * Boot-time commit
+ *
+ * initFlashWearCounter() stages the boot counter increment (and, on first
+ * boot or migration, the initial wear record) and commits them together:
+ * one EEPROM commit per boot. With deferral enabled it commits nothing;
+ * the staged records go out with the first flushFlashWearCounter(),
+ * serviceFlashWearCounter() or committed wear update, so the commit lands at
+ * the first idle moment instead of on the boot path. A reset before then
+ * does not count the boot. On ESP32 the shutdown handler flushes it on
+ * esp_restart().
+ * @param deferred true to defer the boot commit; call before initFlashWearCounter()
+ */
+void setFlashWearBootCommitDeferred(bool deferred);
+const flashWearBootTiming& getFlashWearBootTiming(); // Also logged once by initFlashWearCounter()
+
 /**
  * Initialize the flash wear counter system
  * @param maxWrites maximum number of writes before retirement (default: 12M)
- * @param counterAddress EEPROM address for counter storage (default: 255)
+ * @param counterAddress EEPROM address of the legacy single-record counter, read once to
+ *        seed an empty log (default: 255)
+ * @param bootCounterAddress EEPROM address of the legacy boot counter record (default: 247)
  * @return true if initialization successful, false otherwise
  */
 bool initFlashWearCounter(uint32_t maxWrites = DEFAULT_MAX_FLASH_WRITES,
@@ -48,9 +401,128 @@ bool initFlashWearCounter(uint32_t maxWrites = DEFAULT_MAX_FLASH_WRITES,
 
 /**
  * Update the flash wear counter after a successful write operation
+ *
+ * Besides counting the write, accumulates the bytes written and an estimate
+ * of the sectors erased for it: a copy-on-write filesystem (LittleFS) puts
+ * rewritten data in freshly erased blocks, so a write costs
+ * ceil(bytesWritten / blockSize) erases. Unknown sizes (0) count as one.
+ * @param bytesWritten bytes the write stored (as returned by File::print)
+ * @param blockSize filesystem block size in bytes
  * @return true if counter updated successfully, false otherwise
  */
-bool updateFlashWearCounter();
+bool updateFlashWearCounter(size_t bytesWritten = 0, size_t blockSize = DEFAULT_FS_BLOCK_SIZE);
+
+/**
+ * Express the retirement limit in erase cycles instead of writes.
+ *
+ * With a limit set, the wear percentage (and so every threshold and
+ * getWarningLevel()) is estimated sectors erased / (cyclesPerBlock * blockCount),
+ * i.e. the average erase count per block assuming the filesystem levels
+ * wear, against the flash endurance. Pass 0 to go back to maxWrites.
+ * @param cyclesPerBlock rated erase cycles per block (e.g. 100000 for SPI NOR)
+ * @param blockCount blocks in the filesystem partition (totalBytes() / block size)
+ */
+void setEraseCycleLimit(uint32_t cyclesPerBlock, uint32_t blockCount);
+
+/**
+ * Accounting totals since the counter was first initialized
+ */
+uint64_t getFlashBytesWritten();
+uint32_t getFlashSectorsErased();
+float getFlashEraseCyclesPerBlock(); // 0 unless setEraseCycleLimit() was called
+
+/**
+ * Wear-rate forecasting
+ *
+ * The write rate is an exponentially weighted moving average in writes per
+ * powered-on hour. It is sampled every sampleMs (on update and in
+ * serviceFlashWearCounter()); a sample spanning n intervals gets the weight
+ * 1 - (1 - alpha)^n, so a device that was quiet for a long time converges
+ * as if it had been sampled throughout. The average and the lifetime uptime
+ * are stored with every wear commit, so the forecast continues across
+ * boots; a device upgraded from an older record format starts from its
+ * lifetime average once it has an hour of recorded uptime.
+ *
+ * getFlashWearForecast() projects the hours until the caution, critical and
+ * retirement thresholds (in erase cycles when setEraseCycleLimit() is used),
+ * so replacements can be scheduled before handleDeviceRetirement() fires.
+ * @param alpha weight of one sample interval (0 < alpha <= 1)
+ * @param sampleMs sample interval in milliseconds
+ */
+void setWearRateSmoothing(float alpha = DEFAULT_WEAR_RATE_ALPHA,
+                          unsigned long sampleMs = DEFAULT_WEAR_RATE_SAMPLE_MS);
+float getFlashWriteRate();                // Writes per hour, 0 until the first sample
+flashWearForecast getFlashWearForecast();
+
+/**
+ * Attribute a write to the config domain and file that made it
+ *
+ * configManager calls this for every file it writes, with its registered
+ * domain (see configManager::setDomain()) and the file path, before the
+ * single updateFlashWearCounter() of the save. Counts, bytes, estimated
+ * sector erases and write times are kept in RAM per domain/path pair, so
+ * they cover the current boot only. At most DEFAULT_FLASH_WEAR_MAX_SOURCES
+ * entries are kept; the last one, "(other)", sums pairs that did not fit.
+ * @param domain writer's domain name (nullptr or "" if unregistered)
+ * @param path file written
+ * @param bytesWritten bytes stored
+ * @param blockSize filesystem block size in bytes
+ */
+void attributeFlashWrite(const char* domain, const char* path, size_t bytesWritten,
+                         size_t blockSize = DEFAULT_FS_BLOCK_SIZE);
+
+/**
+ * Attributed write statistics
+ *
+ * getFlashWearDomainStats() sums all files of a domain (path is empty).
+ * getFlashWearSourcesJson() lists every pair, e.g.
+ * [{"domain":"wifi","path":"/wifi.json","writes":3,"bytes":512,"sectors":3,"lastMs":81234,"perHour":4.2},...]
+ */
+const std::vector<flashWearSourceStats>& getFlashWearSources();
+flashWearSourceStats getFlashWearDomainStats(const String& domain);
+const flashWearSourceStats* getChattiestFlashWriter(); // Most estimated erases, nullptr if none
+String getFlashWearSourcesJson();
+void resetFlashWearSources();
+
+/**
+ * Deferred commit policy
+ *
+ * By default every updateFlashWearCounter() commits to EEPROM. With a batch
+ * size above 1, increments accumulate in RAM and are committed when
+ * commitEvery are pending, when the oldest pending increment is older than
+ * commitWindowMs (checked on update and in serviceFlashWearCounter()), or on
+ * flushFlashWearCounter().
+ *
+ * Power loss loses at most the pending increments: the persisted count may
+ * under-count by up to commitEvery - 1 writes, or by the writes made within
+ * commitWindowMs when that is reached first. On ESP32 a shutdown handler
+ * flushes every batching instance on esp_restart(); on ESP8266 call
+ * flushFlashWearCounter() (or flashWearCounter::flushAll()) before
+ * ESP.restart() or deep sleep.
+ * @param commitEvery increments per commit (1 = commit every update)
+ * @param commitWindowMs maximum age of a pending increment, 0 to disable
+ */
+void setFlashWearCommitPolicy(uint16_t commitEvery = DEFAULT_FLASH_WEAR_COMMIT_EVERY,
+                              unsigned long commitWindowMs = DEFAULT_FLASH_WEAR_COMMIT_WINDOW_MS);
+
+/**
+ * Commit pending increments now (shutdown, before sleep or OTA)
+ * @return true if nothing was pending or the commit succeeded
+ */
+bool flushFlashWearCounter();
+
+/**
+ * Commit pending increments whose time window has elapsed; call from loop()
+ * @return true if nothing was due or the commit succeeded
+ */
+bool serviceFlashWearCounter();
+
+/**
+ * Deferred commit metrics
+ */
+uint16_t getFlashWearPendingIncrements();
+uint32_t getFlashWearCommitCount();     // EEPROM commits of the wear counter since boot
+uint32_t getFlashWearCommitsAvoided();  // Increments persisted by another increment's commit
 
 /**
  * Get the current number of flash writes performed
@@ -128,6 +600,22 @@ bool resetFlashWearCounter();
  */
 String getFlashWearStatusString();
 
+/**
+ * Fill a telemetry snapshot of the wear and boot counters
+ * @param out snapshot to fill
+ */
+void getFlashWearTelemetry(flashWearTelemetry* out);
+
+/**
+ * Per-write logging
+ *
+ * updateFlashWearCounter() only logs when the warning level changes (and
+ * the first time it is above normal after boot). Verbose logging restores a
+ * line per update and per EEPROM commit, for debugging the counter itself.
+ * @param verbose true to log every update and commit
+ */
+void setFlashWearVerboseLogging(bool verbose);
+
 /**
  * Check if a warning should be issued based on current wear level
  * @return warning level: 0=none, 1=caution, 2=critical, 3=retirement
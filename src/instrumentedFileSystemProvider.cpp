@@ -0,0 +1,179 @@
+#include <instrumentedFileSystemProvider.hpp>
+#include <string.h>
+
+#ifdef CONFIGMGR_NATIVE
+#include <chrono>
+#endif
+
+instrumentedFileSystemProvider::instrumentedFileSystemProvider(iFileSystemProvider* inner) :
+    _inner(inner)
+{
+    resetStats();
+}
+
+bool instrumentedFileSystemProvider::begin()
+{
+    const uint32_t start = nowMicros();
+    const bool ok = _inner && _inner->begin();
+    record(IO_OP_BEGIN, start, ok);
+    return ok;
+}
+
+bool instrumentedFileSystemProvider::end()
+{
+    const uint32_t start = nowMicros();
+    const bool ok = _inner && _inner->end();
+    record(IO_OP_END, start, ok);
+    return ok;
+}
+
+fs::File instrumentedFileSystemProvider::open(const char *path, const char *mode)
+{
+    const uint32_t start = nowMicros();
+    fs::File file = _inner ? _inner->open(path, mode) : fs::File();
+    record(IO_OP_OPEN, start, static_cast<bool>(file));
+    return file;
+}
+
+bool instrumentedFileSystemProvider::remove(const char *path)
+{
+    const uint32_t start = nowMicros();
+    const bool ok = _inner && _inner->remove(path);
+    record(IO_OP_REMOVE, start, ok);
+    return ok;
+}
+
+bool instrumentedFileSystemProvider::exists(const char *path)
+{
+    const uint32_t start = nowMicros();
+    const bool ok = _inner && _inner->exists(path);
+    record(IO_OP_EXISTS, start, ok);
+    return ok;
+}
+
+bool instrumentedFileSystemProvider::mkdir(const char *path)
+{
+    // Directory creation is rare (shard layout setup); not worth its own histogram
+    return _inner && _inner->mkdir(path);
+}
+
+String instrumentedFileSystemProvider::readFile(const char *path)
+{
+    const uint32_t start = nowMicros();
+    String content = _inner ? _inner->readFile(path) : String();
+    record(IO_OP_READ, start, !content.isEmpty());
+    _bytesRead += content.length();
+    return content;
+}
+
+size_t instrumentedFileSystemProvider::writeFile(const char *path, const String &content)
+{
+    const uint32_t start = nowMicros();
+    const size_t written = _inner ? _inner->writeFile(path, content) : 0;
+    record(IO_OP_WRITE, start, written > 0);
+    _bytesWritten += written;
+    return written;
+}
+
+const ioOperationStats& instrumentedFileSystemProvider::getOperationStats(ioOperation op) const
+{
+    return _stats[op < IO_OP_COUNT ? op : IO_OP_BEGIN];
+}
+
+void instrumentedFileSystemProvider::resetStats()
+{
+    memset(_stats, 0, sizeof(_stats));
+    _bytesRead = 0;
+    _bytesWritten = 0;
+}
+
+String instrumentedFileSystemProvider::getStatsJson() const
+{
+    // Built with snprintf into a reusable buffer to keep String reallocations down
+    char buf[96];
+    String json;
+    json.reserve(128 + IO_OP_COUNT * (48 + IO_LATENCY_BUCKETS * 4));
+
+    snprintf(buf, sizeof(buf), "{\"bytesRead\":%llu,\"bytesWritten\":%llu,\"ops\":{",
+             static_cast<unsigned long long>(_bytesRead), static_cast<unsigned long long>(_bytesWritten));
+    json += buf;
+
+    bool first = true;
+    for (uint8_t op = 0; op < IO_OP_COUNT; op++)
+    {
+        const ioOperationStats& s = _stats[op];
+        if (s.count == 0)
+        {
+            continue;
+        }
+        snprintf(buf, sizeof(buf), "%s\"%s\":{\"n\":%lu,\"fail\":%lu,\"us\":%llu,\"max\":%lu,\"hist\":[",
+                 first ? "" : ",", operationName(static_cast<ioOperation>(op)),
+                 static_cast<unsigned long>(s.count), static_cast<unsigned long>(s.failures),
+                 static_cast<unsigned long long>(s.totalMicros), static_cast<unsigned long>(s.maxMicros));
+        json += buf;
+        first = false;
+
+        // Trailing empty buckets are trimmed; bucket i counts latencies below 2^i us
+        uint8_t last = IO_LATENCY_BUCKETS;
+        while (last > 0 && s.histogram[last - 1] == 0)
+        {
+            last--;
+        }
+        for (uint8_t b = 0; b < last; b++)
+        {
+            snprintf(buf, sizeof(buf), "%s%lu", b ? "," : "", static_cast<unsigned long>(s.histogram[b]));
+            json += buf;
+        }
+        json += "]}";
+    }
+    json += "}}";
+    return json;
+}
+
+const char* instrumentedFileSystemProvider::operationName(ioOperation op)
+{
+    switch (op)
+    {
+        case IO_OP_BEGIN:  return "begin";
+        case IO_OP_END:    return "end";
+        case IO_OP_OPEN:   return "open";
+        case IO_OP_READ:   return "read";
+        case IO_OP_WRITE:  return "write";
+        case IO_OP_REMOVE: return "remove";
+        case IO_OP_EXISTS: return "exists";
+        default:           return "unknown";
+    }
+}
+
+uint32_t instrumentedFileSystemProvider::nowMicros()
+{
+#ifdef CONFIGMGR_NATIVE
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#else
+    return micros();
+#endif
+}
+
+void instrumentedFileSystemProvider::record(ioOperation op, uint32_t startMicros, bool ok)
+{
+    const uint32_t elapsed = nowMicros() - startMicros;
+    ioOperationStats& s = _stats[op];
+    s.count++;
+    if (!ok)
+    {
+        s.failures++;
+    }
+    s.totalMicros += elapsed;
+    if (elapsed > s.maxMicros)
+    {
+        s.maxMicros = elapsed;
+    }
+
+    uint8_t bucket = 0;
+    while (bucket < IO_LATENCY_BUCKETS - 1 && (elapsed >> bucket) != 0)
+    {
+        bucket++;
+    }
+    s.histogram[bucket]++;
+}
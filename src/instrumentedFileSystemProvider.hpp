@@ -0,0 +1,93 @@
+#pragma once
+
+#include <Arduino.h>
+#include <interface/iFileSystemProvider.hpp>
+
+const uint8_t IO_LATENCY_BUCKETS = 16; // Power-of-two buckets: <1us, <2us, <4us ... >=16ms
+
+/**
+ * @brief Operations tracked by instrumentedFileSystemProvider.
+ */
+enum ioOperation : uint8_t {
+    IO_OP_BEGIN = 0,
+    IO_OP_END,
+    IO_OP_OPEN,
+    IO_OP_READ,   // readFile()
+    IO_OP_WRITE,  // writeFile()
+    IO_OP_REMOVE,
+    IO_OP_EXISTS,
+    IO_OP_COUNT
+};
+
+/**
+ * @brief Per-operation counters and latency histogram.
+ */
+struct ioOperationStats {
+    uint32_t count;
+    uint32_t failures;
+    uint64_t totalMicros;
+    uint32_t maxMicros;
+    uint32_t histogram[IO_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Decorator that counts and times every call made to another provider.
+ *
+ * Forwards all calls to the wrapped iFileSystemProvider and records call
+ * counts, failures, bytes moved by readFile()/writeFile() and a latency
+ * histogram per operation. Timing uses micros() on device and
+ * std::chrono::steady_clock on native.
+ *
+ * Bytes are counted for whole-file reads and writes, which is how
+ * configManager accesses storage. Streams returned by open() are passed
+ * through untouched, so only the open itself is counted and timed.
+ *
+ * Usage:
+ *   littleFSProvider flash;
+ *   instrumentedFileSystemProvider io(&flash);
+ *   configManager config(&io, "/config.json");
+ *   ...
+ *   Serial.println(io.getStatsJson());
+ */
+class instrumentedFileSystemProvider : public iFileSystemProvider
+{
+public:
+    explicit instrumentedFileSystemProvider(iFileSystemProvider* inner);
+
+    bool begin() override;
+    bool end() override;
+    fs::File open(const char *path, const char *mode) override;
+    bool remove(const char *path) override;
+    bool exists(const char *path) override;
+    bool mkdir(const char *path) override;
+    size_t blockSize() override { return _inner ? _inner->blockSize() : DEFAULT_FS_BLOCK_SIZE; }
+    String readFile(const char *path) override;
+    size_t writeFile(const char *path, const String &content) override;
+
+    // Statistics queries
+    const ioOperationStats& getOperationStats(ioOperation op) const;
+    uint32_t getMountCount() const { return _stats[IO_OP_BEGIN].count; }
+    uint32_t getOpenCount() const { return _stats[IO_OP_OPEN].count + _stats[IO_OP_READ].count + _stats[IO_OP_WRITE].count; }
+    uint64_t getBytesRead() const { return _bytesRead; }
+    uint64_t getBytesWritten() const { return _bytesWritten; }
+    void resetStats();
+
+    /**
+     * Compact JSON dump for telemetry, e.g.
+     * {"bytesRead":812,"bytesWritten":1624,"ops":{"begin":{"n":3,"fail":0,"us":41,"max":20,"hist":[..]},...}}
+     * Operations that were never called are omitted.
+     */
+    String getStatsJson() const;
+
+    static const char* operationName(ioOperation op);
+    iFileSystemProvider* getInner() const { return _inner; }
+
+private:
+    static uint32_t nowMicros();
+    void record(ioOperation op, uint32_t startMicros, bool ok);
+
+    iFileSystemProvider* _inner;
+    ioOperationStats _stats[IO_OP_COUNT];
+    uint64_t _bytesRead;
+    uint64_t _bytesWritten;
+};
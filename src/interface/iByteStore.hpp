@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * @brief Interface for a small byte-addressable persistent store.
+ *
+ * Models the Arduino EEPROM emulation: reads and writes go to a RAM image,
+ * commit() persists it. flashWearCounter uses this so its counter logic can
+ * run against real EEPROM on device and against RAM or a file on native.
+ */
+class iByteStore
+{
+public:
+    virtual ~iByteStore() = default;
+
+    /**
+     * @brief Prepares the store.
+     * @param size Number of bytes requested.
+     * @return true on success, false on failure.
+     */
+    virtual bool begin(size_t size) = 0;
+
+    /**
+     * @brief Usable size of the store in bytes.
+     */
+    virtual size_t length() const = 0;
+
+    /**
+     * @brief Reads one byte from the RAM image.
+     * @param address Byte offset, must be below length().
+     */
+    virtual uint8_t read(size_t address) const = 0;
+
+    /**
+     * @brief Writes one byte to the RAM image; not persistent until commit().
+     * @param address Byte offset, must be below length().
+     * @param value The byte to store.
+     */
+    virtual void write(size_t address, uint8_t value) = 0;
+
+    /**
+     * @brief Persists pending writes.
+     * @return true on success, false on failure.
+     */
+    virtual bool commit() = 0;
+};
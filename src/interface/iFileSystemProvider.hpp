@@ -3,6 +3,8 @@
 #include <Arduino.h>
 #include <FS.h>
 
+const size_t DEFAULT_FS_BLOCK_SIZE = 4096; // LittleFS/SPIFFS block (one flash sector) on ESP32/ESP8266
+
 /**
  * @brief Interface for a file system provider.
  *
@@ -48,4 +50,66 @@ public:
      * @return true if the file exists, false otherwise.
      */
     virtual bool exists(const char *path) = 0;
+
+    /**
+     * @brief Creates a directory.
+     *
+     * The default does nothing and reports success, which suits flat
+     * filesystems (SPIFFS) where "/dir/file" is just a file name.
+     * @param path The directory path.
+     * @return true if the directory exists afterwards, false on failure.
+     */
+    virtual bool mkdir(const char *path)
+    {
+        (void)path;
+        return true;
+    }
+
+    /**
+     * @brief Erase unit of the underlying flash, used for wear accounting.
+     * @return Block size in bytes.
+     */
+    virtual size_t blockSize()
+    {
+        return DEFAULT_FS_BLOCK_SIZE;
+    }
+
+    /**
+     * @brief Reads a whole file into a String.
+     *
+     * The default implementation opens the file through open() and reads it
+     * in one pass. Providers that emulate, cache or instrument storage override
+     * this so whole-file loads can be served or counted without a File stream.
+     * @param path The path to the file.
+     * @return The file contents, or an empty String if it could not be read.
+     */
+    virtual String readFile(const char *path)
+    {
+        fs::File file = open(path, "r");
+        if (!file)
+        {
+            return String();
+        }
+        String content = file.readString();
+        file.close();
+        return content;
+    }
+
+    /**
+     * @brief Replaces the contents of a file.
+     * @param path The path to the file.
+     * @param content The data to write.
+     * @return Number of bytes written, 0 on failure.
+     */
+    virtual size_t writeFile(const char *path, const String &content)
+    {
+        fs::File file = open(path, "w");
+        if (!file)
+        {
+            return 0;
+        }
+        size_t written = file.print(content);
+        file.close();
+        return written;
+    }
 };
@@ -74,6 +74,11 @@ bool littleFSProvider::exists(const char *path)
     return LITTLEFS_CONFIG_FS.exists(path);
 }
 
+bool littleFSProvider::mkdir(const char *path)
+{
+    return LITTLEFS_CONFIG_FS.exists(path) || LITTLEFS_CONFIG_FS.mkdir(path);
+}
+
 size_t littleFSProvider::totalBytes()
 {
 #if defined(ESP32) || defined(ESP8266)
@@ -4,17 +4,25 @@
 #include "configManager.hpp"
 #include "../test/testLib.hpp"
 #include "../test/advancedTestSuite_simple.hpp"
+#include "../test/providerTestSuite.hpp"
+#include "../test/wearCounterTestSuite.hpp"
+#include "../test/concurrencyTestSuite.hpp"
 
 int main() {
     Serial.begin(115200);
     Serial.println("=== configManager Native Test Runner ===");
 
+    initFlashWearCounter();
+
     nativeFileSystemProvider fs;
     configManager cfg(&fs, "native_config.json");
     cfg.loadConfig();
 
     testLib::runAllTests(&cfg);
     advancedTestSuite::runAdvancedTests();
+    providerTestSuite::runProviderTests();
+    wearCounterTestSuite::runWearCounterTests();
+    concurrencyTestSuite::runConcurrencyTests();
 
     Serial.println("All native tests complete.");
     return 0;
@@ -0,0 +1,99 @@
+#include <parallelRunner.hpp>
+
+#if defined(CONFIGMGR_NATIVE)
+#include <functional>
+#include <thread>
+#include <vector>
+#endif
+
+uint8_t parallelRunner::getWorkerCount(size_t count)
+{
+    if (count < 2)
+    {
+        return 1;
+    }
+#if defined(ESP32) && portNUM_PROCESSORS > 1
+    return 2;
+#elif defined(CONFIGMGR_NATIVE)
+    size_t workers = std::thread::hardware_concurrency();
+    if (workers == 0)
+    {
+        workers = 1;
+    }
+    if (workers > static_cast<size_t>(PARALLEL_MAX_THREADS) + 1)
+    {
+        workers = static_cast<size_t>(PARALLEL_MAX_THREADS) + 1;
+    }
+    return static_cast<uint8_t>(workers < count ? workers : count);
+#else
+    return 1;
+#endif
+}
+
+void parallelRunner::run(size_t count, parallelJob job, void* context)
+{
+    batch work;
+    work.next = 0;
+    work.count = count;
+    work.job = job;
+    work.context = context;
+    const uint8_t workers = getWorkerCount(count);
+
+#if defined(ESP32) && portNUM_PROCESSORS > 1
+    TaskHandle_t helper = nullptr;
+    work.helperDone = nullptr;
+    if (workers > 1)
+    {
+        work.helperDone = xSemaphoreCreateBinary();
+        const BaseType_t otherCore = xPortGetCoreID() == 0 ? 1 : 0;
+        if (work.helperDone &&
+            xTaskCreatePinnedToCore(helperEntry, "cfgParallel", PARALLEL_TASK_STACK, &work,
+                                    uxTaskPriorityGet(nullptr), &helper, otherCore) != pdPASS)
+        {
+            // No memory for a second task: the caller does all of it
+            helper = nullptr;
+        }
+    }
+    drain(work);
+    if (helper)
+    {
+        xSemaphoreTake(work.helperDone, portMAX_DELAY);
+    }
+    if (work.helperDone)
+    {
+        vSemaphoreDelete(work.helperDone);
+    }
+#elif defined(CONFIGMGR_NATIVE)
+    std::vector<std::thread> helpers;
+    for (uint8_t i = 1; i < workers; i++)
+    {
+        helpers.emplace_back(&parallelRunner::drain, std::ref(work));
+    }
+    drain(work);
+    for (auto& helper : helpers)
+    {
+        helper.join();
+    }
+#else
+    (void)workers;
+    drain(work);
+#endif
+}
+
+void parallelRunner::drain(batch& work)
+{
+    for (size_t index = work.next.fetch_add(1); index < work.count; index = work.next.fetch_add(1))
+    {
+        work.job(index, work.context);
+    }
+}
+
+#if defined(ESP32)
+void parallelRunner::helperEntry(void* arg)
+{
+    batch* work = static_cast<batch*>(arg);
+    drain(*work);
+    xSemaphoreGive(work->helperDone);
+    vTaskDelete(nullptr);
+}
+#endif
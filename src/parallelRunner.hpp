@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
+const uint32_t PARALLEL_TASK_STACK = 8192;       // ESP32 helper stack (JSON parsing)
+const uint8_t PARALLEL_MAX_THREADS = 4;          // Native: helper threads besides the caller
+
+typedef void (*parallelJob)(size_t index, void* context);
+
+/**
+ * @brief Runs a batch of independent jobs on every available core and waits for them.
+ *
+ * The calling task works through the jobs together with helpers that exist
+ * only for the duration of run(): on ESP32 one task pinned to the other core
+ * (at the caller's priority), on native up to PARALLEL_MAX_THREADS
+ * std::threads. Jobs are handed out one at a time, so a large job on one core
+ * does not hold back the small ones queued behind it. Single-core chips and
+ * platforms without a threading layer (ESP8266) run the jobs in order on the
+ * caller.
+ *
+ * Jobs must not touch shared state without their own locking; run() only
+ * guarantees that all of them have finished when it returns.
+ *
+ * Usage:
+ *   parallelRunner::run(files.size(), parseFile, &files);
+ */
+class parallelRunner
+{
+public:
+    static void run(size_t count, parallelJob job, void* context);
+
+    // Cores (or hardware threads) run() spreads jobs over, caller included
+    static uint8_t getWorkerCount(size_t count);
+
+private:
+    struct batch {
+        std::atomic<size_t> next;
+        size_t count;
+        parallelJob job;
+        void* context;
+#if defined(ESP32)
+        SemaphoreHandle_t helperDone;
+#endif
+    };
+
+    static void drain(batch& work);
+#if defined(ESP32)
+    static void helperEntry(void* arg);
+#endif
+};
@@ -42,4 +42,10 @@ bool platformFileSystemProvider::exists(const char *path)
     return CONFIG_FS.exists(path);
 }
 
+bool platformFileSystemProvider::mkdir(const char *path)
+{
+    // SPIFFS has no directories and may refuse; its "/dir/file" names work regardless
+    return CONFIG_FS.exists(path) || CONFIG_FS.mkdir(path);
+}
+
 #endif // !CONFIGMGR_NATIVE
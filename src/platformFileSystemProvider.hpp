@@ -31,6 +31,7 @@ public:
     fs::File open(const char *path, const char *mode) override;
     bool remove(const char *path) override;
     bool exists(const char *path) override;
+    bool mkdir(const char *path) override;
 };
 
 #endif // !CONFIGMGR_NATIVE
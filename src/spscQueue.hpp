@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @brief Bounded single-producer/single-consumer ring buffer.
+ *
+ * Lock-free and allocation-free: push() and pop() are a few loads and
+ * stores on two atomic indices, so the producer side is safe to call from
+ * an ISR or a high-priority task. Exactly one context may push and exactly
+ * one may pop (several producers are fine only if something else already
+ * serializes them). A push onto a full queue fails and is counted.
+ *
+ * Capacity must be a power of two; Capacity items fit.
+ */
+template <typename T, uint16_t Capacity>
+class spscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "spscQueue capacity must be a power of two");
+
+public:
+    spscQueue() : _head(0), _tail(0), _overflows(0), _highWater(0) {}
+
+    // Producer side
+    bool push(const T& item)
+    {
+        const uint16_t head = _head.load(std::memory_order_relaxed);
+        const uint16_t used = static_cast<uint16_t>(head - _tail.load(std::memory_order_acquire));
+        if (used >= Capacity)
+        {
+            // Only the producer writes the counter, so no read-modify-write is needed
+            _overflows.store(_overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head & (Capacity - 1)] = item;
+        _head.store(static_cast<uint16_t>(head + 1), std::memory_order_release);
+        if (used + 1 > _highWater.load(std::memory_order_relaxed))
+        {
+            _highWater.store(used + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item)
+    {
+        const uint16_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(static_cast<uint16_t>(tail + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Approximate while the other side is active
+    uint16_t size() const
+    {
+        return static_cast<uint16_t>(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr uint16_t capacity() { return Capacity; }
+
+    // Statistics
+    uint32_t getOverflows() const { return _overflows.load(std::memory_order_relaxed); }
+    uint16_t getHighWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+private:
+    T _items[Capacity];
+    std::atomic<uint16_t> _head;        // Next slot to write, producer-owned
+    std::atomic<uint16_t> _tail;        // Next slot to read, consumer-owned
+    std::atomic<uint32_t> _overflows;   // Producer-owned
+    std::atomic<uint16_t> _highWater;   // Producer-owned
+};
@@ -0,0 +1,153 @@
+#include <writeGovernor.hpp>
+
+writeGovernor::writeGovernor(flashWearCounter* counter) :
+    _counter(counter),
+    _burst(DEFAULT_GOVERNOR_BURST),
+    _serviceLifetimeHours(0),
+    _tokens(DEFAULT_GOVERNOR_BURST),
+    _lastRefill(millis()),
+    _allowed(0),
+    _denied(0)
+{
+    _budgets[0] = DEFAULT_GOVERNOR_BUDGET_NORMAL;
+    _budgets[1] = DEFAULT_GOVERNOR_BUDGET_CAUTION;
+    _budgets[2] = DEFAULT_GOVERNOR_BUDGET_CRITICAL;
+    _budgets[3] = DEFAULT_GOVERNOR_BUDGET_RETIREMENT;
+}
+
+void writeGovernor::setBudget(uint8_t warningLevel, float savesPerHour)
+{
+    configExclusiveGuard guard(&_lock);
+    if (warningLevel < GOVERNOR_WARNING_LEVELS)
+    {
+        _budgets[warningLevel] = (savesPerHour > 0.0f) ? savesPerHour : 0.0f;
+    }
+}
+
+float writeGovernor::getBudget(uint8_t warningLevel) const
+{
+    configExclusiveGuard guard(&_lock);
+    return (warningLevel < GOVERNOR_WARNING_LEVELS) ? _budgets[warningLevel] : 0.0f;
+}
+
+void writeGovernor::setBurst(uint8_t saves)
+{
+    configExclusiveGuard guard(&_lock);
+    _burst = saves ? saves : 1;
+    if (_tokens > _burst)
+    {
+        _tokens = _burst;
+    }
+}
+
+void writeGovernor::setServiceLifetime(uint32_t hours)
+{
+    configExclusiveGuard guard(&_lock);
+    _serviceLifetimeHours = hours;
+}
+
+float writeGovernor::getCurrentBudget() const
+{
+    configExclusiveGuard guard(&_lock);
+    return currentBudget();
+}
+
+float writeGovernor::currentBudget() const
+{
+    if (!_counter || !_counter->isInitialized())
+    {
+        return 0.0f;
+    }
+
+    const uint8_t level = _counter->getWarningLevel();
+    float budget = _budgets[level < GOVERNOR_WARNING_LEVELS ? level : GOVERNOR_WARNING_LEVELS - 1];
+    if (level > 0 && _serviceLifetimeHours > 0)
+    {
+        const float writesLeft = _counter->getWritesToWear(_counter->getRetirementThreshold());
+        if (writesLeft >= 0.0f)
+        {
+            const uint32_t usedHours = _counter->getUptimeSeconds() / 3600;
+            const float hoursLeft = (usedHours < _serviceLifetimeHours) ? (float)(_serviceLifetimeHours - usedHours) : 1.0f;
+            float lifetimeBudget = writesLeft / hoursLeft;
+            if (lifetimeBudget <= 0.0f)
+            {
+                // Nothing left: a token bucket cannot express "never", keep a trickle
+                lifetimeBudget = DEFAULT_GOVERNOR_BUDGET_RETIREMENT;
+            }
+            if (budget == 0.0f || lifetimeBudget < budget)
+            {
+                budget = lifetimeBudget;
+            }
+        }
+    }
+    return budget;
+}
+
+bool writeGovernor::tryAcquire()
+{
+    configExclusiveGuard guard(&_lock);
+    refill();
+    if (currentBudget() == 0.0f)
+    {
+        _allowed++;
+        return true;
+    }
+    if (_tokens >= 1.0f)
+    {
+        _tokens -= 1.0f;
+        _allowed++;
+        return true;
+    }
+    _denied++;
+    return false;
+}
+
+unsigned long writeGovernor::getMillisUntilAvailable()
+{
+    configExclusiveGuard guard(&_lock);
+    refill();
+    const float budget = currentBudget();
+    if (budget == 0.0f || _tokens >= 1.0f)
+    {
+        return 0;
+    }
+    return static_cast<unsigned long>((1.0f - _tokens) * 3600000.0f / budget) + 1;
+}
+
+void writeGovernor::refill()
+{
+    const unsigned long now = millis();
+    const unsigned long elapsedMs = now - _lastRefill;
+    _lastRefill = now;
+
+    const float budget = currentBudget();
+    if (budget == 0.0f)
+    {
+        _tokens = _burst;
+        return;
+    }
+    _tokens += elapsedMs * budget / 3600000.0f;
+    if (_tokens > _burst)
+    {
+        _tokens = _burst;
+    }
+}
+
+uint32_t writeGovernor::getAllowed() const
+{
+    configExclusiveGuard guard(&_lock);
+    return _allowed;
+}
+
+uint32_t writeGovernor::getDenied() const
+{
+    configExclusiveGuard guard(&_lock);
+    return _denied;
+}
+
+void writeGovernor::resetStats()
+{
+    configExclusiveGuard guard(&_lock);
+    _allowed = 0;
+    _denied = 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Arduino.h>
+#include <configLock.hpp>
+#include <flashWearCounter.hpp>
+
+// Default saves per hour for each getWarningLevel(): 0 = unlimited
+const float DEFAULT_GOVERNOR_BUDGET_NORMAL = 0.0f;
+const float DEFAULT_GOVERNOR_BUDGET_CAUTION = 60.0f;
+const float DEFAULT_GOVERNOR_BUDGET_CRITICAL = 12.0f;
+const float DEFAULT_GOVERNOR_BUDGET_RETIREMENT = 1.0f;
+const uint8_t DEFAULT_GOVERNOR_BURST = 4;            // Saves that may go out back to back
+const uint8_t GOVERNOR_WARNING_LEVELS = 4;           // normal, caution, critical, retirement
+
+/**
+ * @brief Writes-per-hour budget for configManager saves, tightened as the flash wears.
+ *
+ * A token bucket: each allowed save takes a token, tokens refill at the
+ * budget of the current flash wear warning level and at most burst of them
+ * are kept. A configManager with a governor (configManager::setWriteGovernor())
+ * defers a saveConfig() that finds the bucket empty; the unsaved changes
+ * stay in RAM, further saves coalesce into the pending one and
+ * configManager::serviceDeferredSave() writes it once a token is available.
+ *
+ * With a service lifetime set, from the caution level on the budget is also
+ * capped at the writes left until retirement spread over the remaining
+ * service hours, so the flash lasts as long as the device is meant to.
+ *
+ * One governor is normally shared by every configManager on the same flash,
+ * saving from any task, so the bucket and statistics are guarded by a lock.
+ *
+ * Usage:
+ *   writeGovernor governor;                  // follows defaultFlashWearCounter()
+ *   governor.setServiceLifetime(10UL * 365 * 24);
+ *   config.setWriteGovernor(&governor);
+ *   ...
+ *   loop() { config.serviceDeferredSave(); }
+ */
+class writeGovernor
+{
+public:
+    explicit writeGovernor(flashWearCounter* counter = &defaultFlashWearCounter());
+
+    // Saves per hour at a warning level (0..3); 0 = unlimited
+    void setBudget(uint8_t warningLevel, float savesPerHour);
+    float getBudget(uint8_t warningLevel) const;
+    void setBurst(uint8_t saves);
+    // Intended powered-on hours of the device; 0 disables the lifetime cap
+    void setServiceLifetime(uint32_t hours);
+
+    // Takes a token if one is available
+    bool tryAcquire();
+    // Budget in force now (level budget or lifetime cap), 0 = unlimited
+    float getCurrentBudget() const;
+    // Milliseconds until tryAcquire() can succeed, 0 if it can now
+    unsigned long getMillisUntilAvailable();
+
+    // Statistics
+    uint32_t getAllowed() const;
+    uint32_t getDenied() const;
+    void resetStats();
+
+private:
+    writeGovernor(const writeGovernor&) = delete;
+    writeGovernor& operator=(const writeGovernor&) = delete;
+
+    // Lock held by the caller
+    void refill();
+    float currentBudget() const;
+
+    flashWearCounter* _counter;
+    float _budgets[GOVERNOR_WARNING_LEVELS];
+    uint8_t _burst;
+    uint32_t _serviceLifetimeHours;
+    float _tokens;
+    unsigned long _lastRefill;
+    uint32_t _allowed;
+    uint32_t _denied;
+    mutable configLock _lock;          // Used as a plain mutex
+};
@@ -0,0 +1,674 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Peter K Green (pkg40)
+ * Email: pkg40@yahoo.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Filesystem Provider Test Suite for configManager
+ * Exercises native-only providers (emulated NOR flash) and measures the
+ * flash cost of configManager persistence on the host
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <configManager.hpp>
+#include <cachingFileSystemProvider.hpp>
+#include <instrumentedFileSystemProvider.hpp>
+#include <flashWearCounter.hpp>
+#include <writeGovernor.hpp>
+#include <compat/ramByteStore.hpp>
+#ifdef CONFIGMGR_NATIVE
+#include <compat/norFlashEmulatorProvider.hpp>
+#endif
+
+class providerTestSuite {
+private:
+    static int _testsPassed;
+    static int _testsFailed;
+    static int _totalTests;
+
+public:
+    static void runProviderTests() {
+        Serial.println("\n=== FILESYSTEM PROVIDER TEST SUITE ===");
+
+        _testsPassed = 0;
+        _testsFailed = 0;
+        _totalTests = 0;
+
+#ifdef CONFIGMGR_NATIVE
+        testNorFlashGeometry();
+        testNorFlashWearSpreading();
+        testNorFlashSaveCost();
+        testInstrumentedProvider();
+        testCachingProvider();
+        testShardedLayout();
+        testAsyncSaveFailure();
+        testWriteAttribution();
+        testWriteGovernor();
+        testBatchedSave();
+        measureWearLoggingCost();
+#else
+        Serial.println("--- Skipping NOR flash emulator (native only) ---");
+#endif
+
+        Serial.println("\n=== PROVIDER TEST RESULTS ===");
+        Serial.printf("Total Tests: %d\n", _totalTests);
+        Serial.printf("Passed: %d\n", _testsPassed);
+        Serial.printf("Failed: %d\n", _testsFailed);
+        Serial.println("=============================\n");
+    }
+
+private:
+    static void testAssert(const String& testName, bool condition, const String& message = "") {
+        _totalTests++;
+        if (condition) {
+            Serial.printf("[PASS] %s\n", testName.c_str());
+            _testsPassed++;
+        } else {
+            Serial.printf("[FAIL] %s", testName.c_str());
+            if (message.length() > 0) {
+                Serial.printf(" - %s", message.c_str());
+            }
+            Serial.println();
+            _testsFailed++;
+        }
+    }
+
+#ifdef CONFIGMGR_NATIVE
+    // String(count, char) is String(value, base) on Arduino, not a fill
+    static String filled(size_t length, char c) {
+        String text;
+        text.reserve(length);
+        for (size_t i = 0; i < length; i++) {
+            text += c;
+        }
+        return text;
+    }
+
+    static void testNorFlashGeometry() {
+        Serial.println("--- Testing NOR Flash Geometry ---");
+
+        norFlashEmulatorProvider flash(16, 4096, 256);
+        flash.setMetadataEntrySize(64);
+        flash.begin();
+
+        const String content = filled(1000, 'x');
+        fs::File file = flash.open("/geometry.json", "w");
+        file.print(content);
+        file.close();
+
+        const norFlashEmulatorProvider::Stats& stats = flash.getStats();
+        // 1000 bytes = 3 full pages + 1 partial page, plus one 64 byte metadata commit
+        testAssert("Data pages programmed", stats.pagesProgrammed == 5, String(static_cast<unsigned long>(stats.pagesProgrammed)));
+        testAssert("Bytes programmed", stats.bytesProgrammed == 1064, String(static_cast<unsigned long>(stats.bytesProgrammed)));
+        testAssert("No erase on fresh flash", stats.sectorsErased == 0);
+        testAssert("Round trip", flash.open("/geometry.json", "r").readString() == content);
+        testAssert("Missing file does not open", !flash.open("/missing.json", "r"));
+
+        // 4096 / 64 = 64 commits fill a metadata sector; the next one compacts
+        for (int i = 0; i < 64; i++) {
+            flash.open("/geometry.json", "w").print("y");
+        }
+        testAssert("Metadata compaction", flash.getStats().metadataCompactions == 1);
+        testAssert("No program violations", flash.getStats().programViolations == 0);
+
+        testAssert("Remove", flash.remove("/geometry.json") && !flash.exists("/geometry.json"));
+
+        Serial.println("NOR flash geometry tests completed.\n");
+    }
+
+    static void testNorFlashWearSpreading() {
+        Serial.println("--- Testing NOR Flash Wear Spreading ---");
+
+        norFlashEmulatorProvider flash(34, 4096, 256);
+        flash.begin();
+        for (int i = 0; i < 3200; i++) {
+            flash.open("/wear.json", "w").print(filled(100, static_cast<char>('a' + (i % 26))));
+        }
+
+        // 32 data sectors rewritten 3200 times round-robin: ~100 erases each
+        const uint32_t spread = flash.getSectorEraseCount(33) - flash.getSectorEraseCount(2);
+        testAssert("Erases spread over data sectors", flash.getSectorEraseCount(2) >= 98 && spread <= 1);
+        testAssert("No program violations", flash.getStats().programViolations == 0);
+        const String latest = flash.open("/wear.json", "r").readString();
+        testAssert("Latest content readable", latest.length() == 100 && latest == filled(100, static_cast<char>('a' + (3199 % 26))));
+
+        norFlashEmulatorProvider tiny(4, 4096, 256);
+        tiny.open("/big.json", "w").print(filled(3 * 4096, 'z'));
+        testAssert("Oversized file rejected", !tiny.exists("/big.json"));
+        testAssert("Failed write counted", tiny.getStats().failedWrites == 1);
+
+        Serial.println("NOR flash wear spreading tests completed.\n");
+    }
+
+    static void testNorFlashSaveCost() {
+        Serial.println("--- Measuring configManager Save Cost on NOR Flash ---");
+
+        norFlashEmulatorProvider flash;
+        configManager config(&flash, "/config.json");
+        config.loadConfig();
+
+        const int cycles = 1000;
+        flash.resetStats();
+        const uint32_t estimatedBefore = getFlashSectorsErased();
+        unsigned long start = micros();
+        for (int i = 0; i < cycles; i++) {
+            config.setValue("setpoints", "present", String(i));
+            config.saveConfig();
+        }
+        unsigned long elapsed = micros() - start;
+
+        const norFlashEmulatorProvider::Stats& stats = flash.getStats();
+        Serial.printf("%d saves: %.1f bytes programmed/save, %.3f sectors erased/save, %.1f us simulated flash time/save, %lu us host time\n",
+                      cycles,
+                      static_cast<double>(stats.bytesProgrammed) / cycles,
+                      static_cast<double>(stats.sectorsErased) / cycles,
+                      static_cast<double>(stats.simulatedBusyMicros) / cycles,
+                      elapsed);
+        const uint32_t estimated = getFlashSectorsErased() - estimatedBefore;
+        Serial.printf("Wear counter estimate: %lu sectors erased, emulator: %llu\n",
+                      static_cast<unsigned long>(estimated), static_cast<unsigned long long>(stats.sectorsErased));
+        Serial.printf("Sector erase counts: min %u, max %u\n",
+                      static_cast<unsigned>(flash.getMinSectorEraseCount()),
+                      static_cast<unsigned>(flash.getMaxSectorEraseCount()));
+
+        testAssert("Every save committed", stats.fileCommits == static_cast<uint32_t>(cycles));
+        testAssert("Saves cost flash programs", stats.bytesProgrammed > 0);
+        testAssert("No program violations", stats.programViolations == 0);
+        testAssert("Erase estimate tracks emulator", estimated >= stats.sectorsErased / 2 && estimated <= stats.sectorsErased * 2);
+
+        Serial.println("NOR flash save cost measurement completed.\n");
+    }
+
+    static void testInstrumentedProvider() {
+        Serial.println("--- Testing Instrumented Provider ---");
+
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        configManager config(&io, "/instrumented.json");
+
+        config.loadConfig();
+        testAssert("Load mounts once", io.getMountCount() == 1);
+        testAssert("Missing file read counted as failure", io.getOperationStats(IO_OP_READ).failures == 1);
+
+        config.setValue("test", "key", "value");
+        config.saveConfig();
+        config.loadConfig();
+
+        testAssert("Bytes written match flash data", io.getBytesWritten() > 0 &&
+                   io.getBytesWritten() == io.getBytesRead());
+        testAssert("Write counted", io.getOperationStats(IO_OP_WRITE).count == 1);
+        testAssert("Mounts and unmounts balanced", io.getMountCount() == io.getOperationStats(IO_OP_END).count);
+
+        const ioOperationStats& reads = io.getOperationStats(IO_OP_READ);
+        uint32_t histogramTotal = 0;
+        for (uint8_t b = 0; b < IO_LATENCY_BUCKETS; b++) {
+            histogramTotal += reads.histogram[b];
+        }
+        testAssert("Histogram covers every call", histogramTotal == reads.count);
+
+        String json = io.getStatsJson();
+        Serial.printf("Stats JSON: %s\n", json.c_str());
+        testAssert("JSON dump has totals", json.startsWith("{\"bytesRead\":") && json.endsWith("}}"));
+        testAssert("JSON omits unused ops", json.find("\"remove\"") == String::npos);
+
+        io.resetStats();
+        testAssert("Reset clears counters", io.getOpenCount() == 0 && io.getBytesWritten() == 0);
+
+        Serial.println("Instrumented provider tests completed.\n");
+    }
+
+    static void testCachingProvider() {
+        Serial.println("--- Testing Caching Provider ---");
+
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        cachingFileSystemProvider cache(&io, 4096, 2);
+        configManager config(&cache, "/cached.json");
+
+        config.loadConfig();
+        config.setValue("test", "key", "value");
+        config.saveConfig();
+
+        io.resetStats();
+        config.loadConfig();
+        config.loadConfig();
+        testAssert("Cached load reads no flash", io.getOperationStats(IO_OP_READ).count == 0);
+        testAssert("Cached load does not mount", io.getMountCount() == 0);
+        testAssert("Cache hits counted", cache.getHits() == 2);
+
+        config.setValue("test", "key", "changed");
+        config.saveConfig();
+        testAssert("Write refreshes entry", cache.readFile("/cached.json") == flash.readFile("/cached.json"));
+
+        cache.remove("/cached.json");
+        testAssert("Remove invalidates", cache.readFile("/cached.json").isEmpty());
+
+        cache.writeFile("/a.json", "{\"a\":{}}");
+        cache.writeFile("/b.json", "{\"b\":{}}");
+        cache.readFile("/a.json");
+        cache.writeFile("/c.json", "{\"c\":{}}");
+        testAssert("Entry limit enforced", cache.getCachedEntries() == 2);
+        io.resetStats();
+        cache.readFile("/a.json");
+        testAssert("Least recently used evicted", io.getOperationStats(IO_OP_READ).count == 0);
+        cache.readFile("/b.json");
+        testAssert("Evicted entry re-read from flash", io.getOperationStats(IO_OP_READ).count == 1);
+
+        cache.writeFile("/big.json", filled(5000, 'x'));
+        testAssert("Oversized file not cached", cache.getCachedBytes() <= 4096);
+
+        Serial.println("Caching provider tests completed.\n");
+    }
+
+    // Saves a 12-section config, then changes one key, in both layouts
+    static void measureLayout(configStorageLayout layout, uint64_t& initialBytes, uint64_t& updateBytes,
+                              uint32_t& updateProgrammed, uint32_t& updateErased) {
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        configManager config(&io, "/layout.json");
+        config.setStorageLayout(layout);
+        config.loadConfig();
+        config.clearConfig();
+
+        for (int s = 0; s < 12; s++) {
+            for (int k = 0; k < 6; k++) {
+                config.setValue("section" + String(s), "key" + String(k), "value_" + String(s * 10 + k));
+            }
+        }
+        config.saveConfig();
+        initialBytes = io.getBytesWritten();
+
+        io.resetStats();
+        flash.resetStats();
+        config.setValue("section3", "key2", "changed");
+        config.saveConfig();
+        updateBytes = io.getBytesWritten();
+        updateProgrammed = flash.getStats().bytesProgrammed;
+        updateErased = flash.getStats().sectorsErased;
+    }
+
+    static void testShardedLayout() {
+        Serial.println("--- Testing Sharded Storage Layout ---");
+
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        configManager config(&io, "/sharded.json");
+        config.setStorageLayout(CONFIG_LAYOUT_SHARDED);
+        testAssert("Default shard directory", config.getShardDirectory() == "/sharded.d", config.getShardDirectory());
+        testAssert("Shard name sanitized", config.getShardPath("a/b c").startsWith("/sharded.d/a_b_c~") &&
+                   config.getShardPath("a/b c") != config.getShardPath("a_b_c"));
+
+        config.loadConfig();
+        config.clearConfig();
+        config.setValue("wifi", "ssid", "net");
+        config.setValue("mqtt", "host", "broker");
+        testAssert("Changes tracked per section", config.getDirtySectionCount() == 2);
+        testAssert("First save succeeds", config.saveConfig());
+        testAssert("Shard files written", flash.exists(config.getShardPath("wifi").c_str()) &&
+                   flash.exists(config.getShardPath("mqtt").c_str()) &&
+                   flash.exists(config.getShardManifestPath().c_str()));
+        testAssert("Dirty set cleared", config.getDirtySectionCount() == 0);
+
+        io.resetStats();
+        testAssert("Clean save succeeds", config.saveConfig());
+        testAssert("Clean save writes nothing", io.getOperationStats(IO_OP_WRITE).count == 0);
+
+        config.setValue("wifi", "ssid", "other");
+        config.saveConfig();
+        testAssert("Only dirty shard rewritten", io.getOperationStats(IO_OP_WRITE).count == 1);
+
+        io.resetStats();
+        config.setValue("ntp", "server", "pool");
+        config.saveConfig();
+        testAssert("New section rewrites manifest", io.getOperationStats(IO_OP_WRITE).count == 2);
+
+        config.setValue("dropped", "key", "value");
+        config.saveConfig();
+        const String droppedPath = config.getShardPath("dropped");
+        configTransaction drop = config.beginTransaction();
+        drop.removeSection("dropped");
+        drop.commit();
+        config.saveConfig();
+        testAssert("Removed section's shard deleted", !flash.exists(droppedPath.c_str()));
+        testAssert("Other shards kept", flash.exists(config.getShardPath("ntp").c_str()));
+
+        config.setValue("manifest", "key", "value");
+        config.saveConfig();
+        testAssert("Section named manifest has its own shard", config.getShardPath("manifest") != config.getShardManifestPath() &&
+                   flash.exists(config.getShardPath("manifest").c_str()));
+        testAssert("Manifest not overwritten by section",
+                   flash.readFile(config.getShardManifestPath().c_str()).indexOf(config.getShardPath("ntp")) >= 0);
+
+        config.clearConfig();
+        testAssert("Clear removes shards", !flash.exists(config.getShardPath("wifi").c_str()) &&
+                   !flash.exists(config.getShardManifestPath().c_str()));
+
+        uint64_t singleInitial, singleUpdate, shardedInitial, shardedUpdate;
+        uint32_t singleProgrammed, singleErased, shardedProgrammed, shardedErased;
+        measureLayout(CONFIG_LAYOUT_SINGLE_FILE, singleInitial, singleUpdate, singleProgrammed, singleErased);
+        measureLayout(CONFIG_LAYOUT_SHARDED, shardedInitial, shardedUpdate, shardedProgrammed, shardedErased);
+        Serial.printf("Initial save: single %llu bytes, sharded %llu bytes\n",
+                      static_cast<unsigned long long>(singleInitial), static_cast<unsigned long long>(shardedInitial));
+        Serial.printf("One-key update: single %llu bytes (%lu programmed, %lu erased sectors), sharded %llu bytes (%lu programmed, %lu erased sectors)\n",
+                      static_cast<unsigned long long>(singleUpdate), static_cast<unsigned long>(singleProgrammed),
+                      static_cast<unsigned long>(singleErased), static_cast<unsigned long long>(shardedUpdate),
+                      static_cast<unsigned long>(shardedProgrammed), static_cast<unsigned long>(shardedErased));
+        testAssert("Sharded update writes fewer bytes", shardedUpdate * 4 < singleUpdate);
+        testAssert("Sharded update programs less flash", shardedProgrammed < singleProgrammed);
+
+        Serial.println("Sharded storage layout tests completed.\n");
+    }
+
+    // Forwards to another provider; writes fail while failWrites is set
+    class failingWriteProvider : public iFileSystemProvider {
+    public:
+        explicit failingWriteProvider(iFileSystemProvider* inner) : _inner(inner) {}
+        bool begin() override { return _inner->begin(); }
+        bool end() override { return _inner->end(); }
+        fs::File open(const char* path, const char* mode) override { return _inner->open(path, mode); }
+        bool remove(const char* path) override { return _inner->remove(path); }
+        bool exists(const char* path) override { return _inner->exists(path); }
+        bool mkdir(const char* path) override { return _inner->mkdir(path); }
+        size_t blockSize() override { return _inner->blockSize(); }
+        String readFile(const char* path) override { return _inner->readFile(path); }
+        size_t writeFile(const char* path, const String& content) override {
+            return failWrites ? 0 : _inner->writeFile(path, content);
+        }
+        bool failWrites = false;
+
+    private:
+        iFileSystemProvider* _inner;
+    };
+
+    static void recordAsyncResult(configManager* config, asyncSaveResult result, void* context) {
+        (void)config;
+        *static_cast<asyncSaveResult*>(context) = result;
+    }
+
+    static void testAsyncSaveFailure() {
+        Serial.println("--- Testing Failed Async Saves ---");
+
+        norFlashEmulatorProvider flash;
+        failingWriteProvider faulty(&flash);
+        configStorageLayout layouts[] = {CONFIG_LAYOUT_SINGLE_FILE, CONFIG_LAYOUT_SHARDED};
+        for (configStorageLayout layout : layouts) {
+            const String name = layout == CONFIG_LAYOUT_SHARDED ? "Sharded" : "Single file";
+            configManager config(&faulty, "/asyncFail.json");
+            config.setStorageLayout(layout);
+            config.loadConfig();
+            config.clearConfig();
+            config.setValue("wifi", "ssid", "net");
+
+            asyncSaveResult result = ASYNC_SAVE_OK;
+            faulty.failWrites = true;
+            testAssert(name + ": failing save queued", config.saveConfigAsync(recordAsyncResult, &result));
+            config.waitForAsyncSave();
+            testAssert(name + ": failure reported", result == ASYNC_SAVE_FAILED);
+            testAssert(name + ": sections dirty again", config.getDirtySectionCount() == 1 && config.hasUnsavedChanges());
+
+            faulty.failWrites = false;
+            testAssert(name + ": retry saves", config.saveConfig());
+            const String path = layout == CONFIG_LAYOUT_SHARDED ? config.getShardPath("wifi") : String("/asyncFail.json");
+            testAssert(name + ": retry reached flash", flash.exists(path.c_str()) &&
+                       (layout != CONFIG_LAYOUT_SHARDED || flash.exists(config.getShardManifestPath().c_str())));
+            testAssert(name + ": clean after retry", config.getDirtySectionCount() == 0);
+            config.clearConfig();
+        }
+
+        Serial.println("Failed async save tests completed.\n");
+    }
+
+    static void testWriteAttribution() {
+        Serial.println("--- Testing Per-Domain Write Attribution ---");
+
+        norFlashEmulatorProvider flash;
+        configManager wifi(&flash, "/wifi.json");
+        configManager state(&flash, "/state.json");
+        wifi.setDomain("wifi");
+        state.setDomain("state");
+        state.setStorageLayout(CONFIG_LAYOUT_SHARDED);
+        wifi.loadConfig();
+        state.loadConfig();
+        wifi.clearConfig();
+        state.clearConfig();
+        resetFlashWearSources();
+
+        wifi.setValue("network", "ssid", "home");
+        wifi.saveConfig();
+        for (int i = 0; i < 10; i++) {
+            state.setValue("runtime", "counter", String(i));
+            state.saveConfig();
+        }
+        state.setValue("history", "last", "boot");
+        state.saveConfig();
+
+        const flashWearSourceStats wifiStats = getFlashWearDomainStats("wifi");
+        const flashWearSourceStats stateStats = getFlashWearDomainStats("state");
+        testAssert("Single-file domain attributed", wifiStats.writes == 1 && wifiStats.bytesWritten > 0,
+                   String(wifiStats.writes));
+        // 10 "runtime" shard writes, 1 "history" shard, 2 manifest rewrites
+        testAssert("Sharded domain attributed per file", stateStats.writes == 13, String(stateStats.writes));
+
+        const flashWearSourceStats* runtime = defaultFlashWearCounter().findSource(state.getShardPath("runtime"));
+        testAssert("Shard file tracked", runtime && runtime->writes == 10 && runtime->domain == "state");
+        const flashWearSourceStats* chattiest = getChattiestFlashWriter();
+        testAssert("Chattiest writer found", chattiest && chattiest->path == state.getShardPath("runtime"));
+        testAssert("Write rate reported", runtime && runtime->getWritesPerHour(millis()) > 0.0f);
+        Serial.printf("Attribution: %s\n", getFlashWearSourcesJson().c_str());
+
+        state.clearConfig();
+        wifi.clearConfig();
+        resetFlashWearSources();
+
+        Serial.println("Per-domain write attribution tests completed.\n");
+    }
+
+    static void testWriteGovernor() {
+        Serial.println("--- Testing Write Budget Governor ---");
+
+        ramByteStore store;
+        flashWearCounter wear(&store);
+        wear.begin(1000);
+        writeGovernor governor(&wear);
+        governor.setBudget(1, 36000.0f);   // One save per 100 ms once at caution
+        governor.setBurst(2);
+
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        configManager config(&io, "/governed.json");
+        config.loadConfig();
+        config.clearConfig();
+        config.setWriteGovernor(&governor);
+
+        io.resetStats();
+        for (int i = 0; i < 5; i++) {
+            config.setValue("runtime", "counter", String(i));
+            config.saveConfig();
+        }
+        testAssert("Normal wear is unlimited", io.getOperationStats(IO_OP_WRITE).count == 5 && !config.isSaveDeferred());
+
+        wear.setWarningThresholds(0.0f, 50.0f, 100.0f);  // Caution from the start
+        io.resetStats();
+        for (int i = 0; i < 10; i++) {
+            config.setValue("runtime", "counter", String(100 + i));
+            config.saveConfig();
+        }
+        testAssert("Burst allowed then deferred", io.getOperationStats(IO_OP_WRITE).count == 2,
+                   String(io.getOperationStats(IO_OP_WRITE).count));
+        testAssert("Deferred saves coalesce", config.isSaveDeferred() && config.getSavesDeferred() == 8 &&
+                   config.getSavesCoalesced() == 7);
+        config.serviceDeferredSave();
+        testAssert("Service waits for budget", io.getOperationStats(IO_OP_WRITE).count == 2 && governor.getMillisUntilAvailable() > 0);
+
+        delay(governor.getMillisUntilAvailable() + 5);
+        config.serviceDeferredSave();
+        testAssert("Deferred save written once", io.getOperationStats(IO_OP_WRITE).count == 3 && !config.isSaveDeferred());
+        const String saved = flash.readFile("/governed.json");
+        testAssert("Latest value persisted", strstr(saved.c_str(), "109") != nullptr);
+
+        config.setValue("runtime", "counter", "final");
+        config.saveConfig();
+        config.saveConfig();
+        testAssert("Flush bypasses budget", config.flushConfig() && !config.isSaveDeferred());
+
+        // Async saves draw from the same bucket (empty again after the two saves above)
+        io.resetStats();
+        for (int i = 0; i < 4; i++) {
+            config.setValue("runtime", "counter", "async" + String(i));
+            config.saveConfigAsync();
+            config.waitForAsyncSave();
+        }
+        testAssert("Async saves governed", io.getOperationStats(IO_OP_WRITE).count <= 1 && config.isSaveDeferred(),
+                   String(io.getOperationStats(IO_OP_WRITE).count));
+        delay(governor.getMillisUntilAvailable() + 5);
+        config.serviceDeferredSave();
+        testAssert("Deferred async changes written", !config.isSaveDeferred() && !config.hasUnsavedChanges() &&
+                   strstr(flash.readFile("/governed.json").c_str(), "async3") != nullptr);
+
+        // Lifetime cap: 1000 writes spread over 10 hours, level budget unlimited
+        governor.setBudget(1, 0.0f);
+        governor.setServiceLifetime(10);
+        const float expected = wear.getWritesToWear(100.0f) / 10.0f;
+        testAssert("Lifetime caps the budget", governor.getCurrentBudget() > expected * 0.99f &&
+                   governor.getCurrentBudget() < expected * 1.01f, String(governor.getCurrentBudget(), 1));
+
+        config.clearConfig();
+        Serial.println("Write budget governor tests completed.\n");
+    }
+
+    // saveConfig() latency with the old per-write wear logging and with threshold-only logging
+    static void testBatchedSave() {
+        Serial.println("--- Testing Batched Multi-Domain Save ---");
+
+        norFlashEmulatorProvider flash;
+        instrumentedFileSystemProvider io(&flash);
+        configManager wifi(&io, "/wifi.json");
+        configManager state(&io, "/savedState.json");
+        configManager machine(&io, "/machine.json");
+        configManager idle(&io, "/idle.json");
+        wifi.setDomain("wifi");
+        state.setDomain("state");
+        machine.setDomain("machine");
+        idle.setDomain("idle");
+        machine.setStorageLayout(CONFIG_LAYOUT_SHARDED);
+        configManager* domains[] = {&wifi, &state, &machine, &idle};
+        for (configManager* config : domains) {
+            config->loadConfig();
+            config->clearConfig();
+            config->setValue("base", "value", "0");
+            config->flushConfig();
+        }
+        testAssert("Nothing dirty after flush", !wifi.hasUnsavedChanges() && !machine.hasUnsavedChanges());
+
+        const int rounds = 50;
+        unsigned long sequentialMicros = 0;
+        unsigned long batchedMicros = 0;
+        uint32_t sequentialMounts = 0;
+        uint32_t batchedMounts = 0;
+        uint32_t sequentialWear = 0;
+        uint32_t batchedWear = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            io.resetStats();
+            const uint32_t wearBefore = getFlashWriteCount();
+            const unsigned long start = micros();
+            for (int i = 0; i < rounds; i++) {
+                wifi.setValue("network", "ssid", "net" + String(i));
+                state.setValue("setpoints", "present", String(i));
+                machine.setValue("machine", "step", String(i));
+                if (pass == 0) {
+                    wifi.saveConfig();
+                    state.saveConfig();
+                    machine.saveConfig();
+                } else {
+                    configManager::saveAllDirty();
+                }
+            }
+            const unsigned long elapsed = micros() - start;
+            const uint32_t wear = getFlashWriteCount() - wearBefore;
+            if (pass == 0) {
+                sequentialMicros = elapsed;
+                sequentialMounts = io.getMountCount();
+                sequentialWear = wear;
+            } else {
+                batchedMicros = elapsed;
+                batchedMounts = io.getMountCount();
+                batchedWear = wear;
+            }
+        }
+
+        Serial.printf("%d rounds of 3 dirty domains: sequential %lu us, %lu mounts, %lu wear updates; "
+                      "batched %lu us, %lu mounts, %lu wear updates\n", rounds,
+                      sequentialMicros, static_cast<unsigned long>(sequentialMounts), static_cast<unsigned long>(sequentialWear),
+                      batchedMicros, static_cast<unsigned long>(batchedMounts), static_cast<unsigned long>(batchedWear));
+        testAssert("One mount per batch", batchedMounts == static_cast<uint32_t>(rounds), String(batchedMounts));
+        testAssert("One wear update per batch", batchedWear == static_cast<uint32_t>(rounds), String(batchedWear));
+        testAssert("Sequential saves mount per domain", sequentialMounts == static_cast<uint32_t>(3 * rounds));
+        testAssert("Clean domain skipped", !idle.hasUnsavedChanges() && io.getOperationStats(IO_OP_WRITE).count > 0);
+        testAssert("Batched domains clean", !wifi.hasUnsavedChanges() && !state.hasUnsavedChanges() && !machine.hasUnsavedChanges());
+        testAssert("Batched values on flash", flash.readFile("/savedState.json").length() > 0 &&
+                   flash.exists(machine.getShardPath("machine").c_str()));
+
+        for (configManager* config : domains) {
+            config->clearConfig();
+        }
+
+        Serial.println("Batched multi-domain save tests completed.\n");
+    }
+
+    static void measureWearLoggingCost() {
+        Serial.println("--- Measuring Save Latency vs Wear Logging ---");
+
+        norFlashEmulatorProvider flash;
+        configManager config(&flash, "/latency.json");
+        config.loadConfig();
+        config.clearConfig();
+        config.setValue("runtime", "counter", "0");
+
+        // Pass 0 warms up, pass 1 logs every wear update, pass 2 only threshold crossings
+        const int saves = 500;
+        unsigned long elapsed[3];
+        for (int pass = 0; pass < 3; pass++) {
+            setFlashWearVerboseLogging(pass == 1);
+            unsigned long start = micros();
+            for (int i = 0; i < saves; i++) {
+                config.setValue("runtime", "counter", String(i));
+                config.saveConfig();
+            }
+            elapsed[pass] = micros() - start;
+        }
+        setFlashWearVerboseLogging(false);
+
+        Serial.printf("saveConfig(): %.1f us verbose wear logging, %.1f us threshold-only\n",
+                      elapsed[1] / (float)saves, elapsed[2] / (float)saves);
+        testAssert("Saves completed", flash.exists("/latency.json"));
+        config.clearConfig();
+
+        Serial.println("Save latency measurement completed.\n");
+    }
+#endif
+};
+
+// Static member definitions
+int providerTestSuite::_testsPassed = 0;
+int providerTestSuite::_testsFailed = 0;
+int providerTestSuite::_totalTests = 0;
@@ -39,6 +39,15 @@ private:
     static int _passCount;
     static int _failCount;
     static int _testCount;
+    static int _asyncCallbacks;
+    static int _asyncSucceeded;
+
+    static void onAsyncSave(configManager*, asyncSaveResult result, void*) {
+        _asyncCallbacks++;
+        if (result == ASYNC_SAVE_OK) {
+            _asyncSucceeded++;
+        }
+    }
 
 public:
     // Test result reporting
@@ -135,6 +144,12 @@ public:
         testEdgeCases(config);
         testBackwardCompatibility(config);
         testPerformance(config);
+        testAsyncPersistence(config);
+        testTransactions(config);
+        testChangeNotifications(config);
+        testPostedUpdates(config);
+        testVersions(config);
+        testStreamingExport(config);
         
         finishTests();
     }
@@ -476,6 +491,281 @@ public:
         Serial.println("Performance tests completed.\n");
     }
 
+    // 11. Async Persistence Tests
+    static void testAsyncPersistence(configManager* config) {
+        Serial.println("--- Testing Async Persistence ---");
+
+        _asyncCallbacks = 0;
+        _asyncSucceeded = 0;
+
+        config->setValue("async", "key", "async-first");
+        unsigned long startTime = micros();
+        bool queued = config->saveConfigAsync(onAsyncSave);
+        unsigned long submitTime = micros() - startTime;
+        assertTrue("saveConfigAsync accepted", queued);
+
+        // Changes after submit must not leak into the queued snapshot
+        config->setValue("async", "key", "async-second");
+        assertTrue("Async save completes", config->waitForAsyncSave(5000));
+        assertEqual("Callback invoked once", _asyncCallbacks, 1);
+        iFileSystemProvider* fs = config->getFileSystemProvider();
+        fs->begin();
+        const String saved = fs->readFile(config->getConfigFilePath().c_str());
+        fs->end();
+        assertTrue("Queued snapshot taken at submit", saved.indexOf("\"key\": \"async-first\"") >= 0 &&
+                   saved.indexOf("\"key\": \"async-second\"") < 0);
+        Serial.printf("saveConfigAsync returned in %lu us\n", submitTime);
+
+        // A burst of saves coalesces; every caller still hears back
+        for (int i = 0; i < 5; i++) {
+            config->setValue("async", "burst", String(i));
+            config->saveConfigAsync(onAsyncSave);
+        }
+        assertTrue("Burst completes", config->waitForAsyncSave(5000));
+        assertEqual("Every burst save reported", _asyncCallbacks, 6);
+        assertTrue("At least the newest burst save written", _asyncSucceeded >= 2);
+        assertFalse("Nothing pending after wait", config->isAsyncSavePending());
+
+        // Synchronous save after async must not be overtaken by the older snapshot
+        config->saveConfigAsync();
+        assertTrue("Sync save after async", config->saveConfig());
+        assertFalse("Sync save drains async queue", config->isAsyncSavePending());
+
+        Serial.println("Async persistence tests completed.\n");
+    }
+
+    // 12. Transaction Tests
+    static void testTransactions(configManager* config) {
+        Serial.println("--- Testing Transactions ---");
+
+        config->setValue("txn", "ssid", "old");
+        config->setValue("txn", "bssid", "00:11");
+        config->setValue("txnDrop", "key", "value");
+
+        configTransaction txn = config->beginTransaction();
+        txn.setValue("txn", "ssid", "new")
+           .setValue("txn", "password", "secret")
+           .removeValue("txn", "bssid")
+           .removeSection("txnDrop");
+        assertEqual("Operations staged", static_cast<int>(txn.getOperationCount()), 4);
+        assertEqual("Staged set not applied yet", config->getValue("txn", "ssid"), "old");
+        assertTrue("Commit succeeds", txn.commit());
+        assertFalse("Transaction closed after commit", txn.isOpen());
+        assertEqual("Set applied", config->getValue("txn", "ssid"), "new");
+        assertEqual("Added key applied", config->getValue("txn", "password"), "secret");
+        assertEqual("Key removed", config->getValue("txn", "bssid"), "[NOT FOUND]");
+        assertTrue("Section removed", config->getKeys("txnDrop").empty());
+        assertFalse("Second commit refused", txn.commit());
+
+        configTransaction aborted = config->beginTransaction();
+        aborted.setValue("txn", "ssid", "discarded").removeSection("txn");
+        aborted.rollback();
+        assertFalse("Rolled back transaction refuses commit", aborted.commit());
+        assertEqual("Rollback leaves store untouched", config->getValue("txn", "ssid"), "new");
+
+        {
+            configTransaction abandoned = config->beginTransaction();
+            abandoned.setValue("txn", "ssid", "abandoned");
+        }
+        assertEqual("Uncommitted transaction discarded", config->getValue("txn", "ssid"), "new");
+
+        Serial.println("Transaction tests completed.\n");
+    }
+
+    // 13. Change Notification Tests
+    static void onConfigChange(configManager* config, const String& section, const String& key, void* context) {
+        (void)config;
+        (void)section;
+        (void)key;
+        (*static_cast<int*>(context))++;
+    }
+
+    static void testChangeNotifications(configManager* config) {
+        Serial.println("--- Testing Change Notifications ---");
+
+        int keyCalls = 0;
+        int sectionCalls = 0;
+        configChangeQueue queue;
+        config->setValue("notify", "flag", "0");
+        const uint16_t keyId = config->subscribe("notify", "flag", onConfigChange, &keyCalls);
+        const uint16_t sectionId = config->subscribe("notify", "", onConfigChange, &sectionCalls);
+        const uint16_t queueId = config->subscribe("notify", "flag", &queue);
+        assertTrue("Subscriptions accepted", keyId != 0 && sectionId != 0 && queueId != 0);
+
+        config->setValue("notify", "flag", "1");
+        assertEqual("Key subscriber called", keyCalls, 1);
+        assertEqual("Section subscriber called", sectionCalls, 1);
+        configChangeEvent event;
+        assertTrue("Event queued", queue.pop(event) && event.subscriptionId == queueId);
+
+        config->setValue("notify", "flag", "1");
+        assertEqual("Unchanged value not reported", keyCalls, 1);
+
+        config->setValue("notify", "other", "x");
+        assertEqual("Other key skips key subscriber", keyCalls, 1);
+        assertEqual("Other key reaches section subscriber", sectionCalls, 2);
+        config->setValue("elsewhere", "flag", "1");
+        assertEqual("Other section not reported", sectionCalls, 2);
+
+        configTransaction txn = config->beginTransaction();
+        txn.setValue("notify", "flag", "2").setValue("notify", "flag", "1").setValue("notify", "other", "y");
+        txn.commit();
+        assertEqual("Transaction reports net changes only", keyCalls, 1);
+        assertEqual("Transaction change reported once", sectionCalls, 3);
+        assertFalse("Net-unchanged key not queued", queue.pop(event));
+
+        assertTrue("Unsubscribe", config->unsubscribe(keyId));
+        assertFalse("Unsubscribe twice", config->unsubscribe(keyId));
+        config->setValue("notify", "flag", "3");
+        assertEqual("No call after unsubscribe", keyCalls, 1);
+        config->unsubscribe(sectionId);
+        config->unsubscribe(queueId);
+
+        Serial.println("Change notification tests completed.\n");
+    }
+
+    // 14. Posted (ISR) Update Tests
+    static String addressValue(configManager* config, eePromAddress_t address) {
+        // Not getValue(address): its verbose path needs stringAddressName() from the application
+        return config->getValue(addressMap[address].section, addressMap[address].key);
+    }
+
+    static void testPostedUpdates(configManager* config) {
+        Serial.println("--- Testing Posted Updates ---");
+
+        configUpdateQueue queue;
+        config->attachUpdateQueue(&queue);
+        assertTrue("Post int", queue.post(eePRESENT, static_cast<int32_t>(42)));
+        assertTrue("Post float", queue.post(eeLAST, 1.5f, 1));
+        assertTrue("Post text", queue.post(eeIDLE, "idle-text-that-is-too-long"));
+        assertNotEqual("Nothing applied before service", addressValue(config, eePRESENT), "42");
+
+        assertEqual("Service applies all", static_cast<int>(config->serviceUpdates()), 3);
+        assertEqual("Int value", addressValue(config, eePRESENT), "42");
+        assertEqual("Float value", addressValue(config, eeLAST), "1.5");
+        assertEqual("Text truncated", addressValue(config, eeIDLE), "idle-text-t");
+        assertEqual("Queue drained", static_cast<int>(queue.size()), 0);
+
+        // Fill past capacity: the newest posts are dropped and counted
+        const int extra = 5;
+        for (int i = 0; i < CONFIG_UPDATE_QUEUE_DEPTH + extra; i++) {
+            queue.post(eePRESENT, static_cast<int32_t>(i));
+        }
+        assertEqual("Overflows counted", static_cast<int>(config->getUpdateOverflows()), extra);
+        assertEqual("High water at capacity", static_cast<int>(queue.getHighWater()), CONFIG_UPDATE_QUEUE_DEPTH);
+        assertEqual("Bounded service", static_cast<int>(config->serviceUpdates(10)), 10);
+        config->serviceUpdates();
+        assertEqual("Last accepted post wins", addressValue(config, eePRESENT), String(CONFIG_UPDATE_QUEUE_DEPTH - 1));
+
+        config->detachUpdateQueue(&queue);
+        queue.post(eePRESENT, static_cast<int32_t>(-1));
+        assertEqual("Detached queue ignored", static_cast<int>(config->serviceUpdates()), 0);
+
+        Serial.println("Posted update tests completed.\n");
+    }
+
+    // 15. Change Version / ETag Tests
+    static void testVersions(configManager* config) {
+        Serial.println("--- Testing Change Versions ---");
+
+        config->setValue("etagA", "key", "1");
+        config->setValue("etagB", "key", "1");
+        const uint32_t store = config->getVersion();
+        const uint32_t sectionA = config->getSectionVersion("etagA");
+        const String storeTag = config->getETag();
+        const String tagA = config->getETag("etagA");
+        assertTrue("Section version set", sectionA != 0 && sectionA <= store);
+        assertEqual("Unknown section has version 0", static_cast<int>(config->getSectionVersion("etagNone")), 0);
+        assertTrue("Current tag matches", config->matchesETag(storeTag) && config->matchesETag("W/" + tagA, "etagA"));
+        assertTrue("Tag list matches", config->matchesETag("\"other\", " + storeTag));
+        assertTrue("Wildcard matches", config->matchesETag("*"));
+
+        config->setValue("etagA", "key", "1");
+        assertEqual("Unchanged value keeps version", static_cast<int>(config->getVersion()), static_cast<int>(store));
+
+        config->setValue("etagB", "key", "2");
+        assertTrue("Store version bumped", config->getVersion() == store + 1);
+        assertEqual("Other section keeps version", static_cast<int>(config->getSectionVersion("etagA")), static_cast<int>(sectionA));
+        assertTrue("Other section still not modified", config->matchesETag(tagA, "etagA"));
+        assertFalse("Store tag stale", config->matchesETag(storeTag));
+
+        const uint32_t beforeTxn = config->getVersion();
+        configTransaction txn = config->beginTransaction();
+        txn.setValue("etagA", "key", "2").setValue("etagB", "key", "3");
+        txn.commit();
+        assertEqual("Transaction is one version", static_cast<int>(config->getVersion()), static_cast<int>(beforeTxn + 1));
+        assertTrue("Both sections at transaction version",
+                   config->getSectionVersion("etagA") == beforeTxn + 1 && config->getSectionVersion("etagB") == beforeTxn + 1);
+        assertFalse("Changed section tag stale", config->matchesETag(tagA, "etagA"));
+
+        configTransaction noop = config->beginTransaction();
+        noop.setValue("etagA", "key", "2").removeValue("etagA", "missing");
+        noop.commit();
+        assertEqual("Net no-op transaction keeps version", static_cast<int>(config->getVersion()), static_cast<int>(beforeTxn + 1));
+
+        configTransaction drop = config->beginTransaction();
+        drop.removeSection("etagB");
+        drop.commit();
+        assertTrue("Removed section version bumped", config->getSectionVersion("etagB") == config->getVersion());
+
+        Serial.println("Change version tests completed.\n");
+    }
+
+    // 16. Streaming Export Tests
+    class capturePrint : public Print {
+    public:
+        using Print::write;
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        size_t write(const uint8_t* buffer, size_t size) override {
+            const size_t accepted = (limit && text.length() + size > limit) ? limit - text.length() : size;
+            text += String(reinterpret_cast<const char*>(buffer), accepted);
+            calls++;
+            largest = std::max(largest, size);
+            return accepted;
+        }
+        String text;
+        size_t calls = 0;
+        size_t largest = 0;
+        size_t limit = 0;          // Accept this many bytes in total, 0 = unlimited
+    };
+
+    static void testStreamingExport(configManager* config) {
+        Serial.println("--- Testing Streaming Export ---");
+
+        config->setValue("exportA", "plain", "value");
+        config->setValue("exportA", "quoted", "say \"hi\"\\\n");
+        config->setValue("exportB", "key", "1");
+
+        capturePrint one;
+        const size_t written = config->exportJson(one, "exportA");
+        assertEqual("Section JSON", one.text,
+                    "{\"exportA\":{\"plain\":\"value\",\"quoted\":\"say \\\"hi\\\"\\\\\\n\"}}");
+        assertEqual("Bytes reported", static_cast<int>(written), static_cast<int>(one.text.length()));
+
+        capturePrint some;
+        config->exportJson(some, std::vector<String>{"exportB", "exportMissing", "exportA"});
+        assertTrue("Set keeps order, skips missing",
+                   some.text.startsWith("{\"exportB\":{\"key\":\"1\"},\"exportA\":") && some.text.indexOf("exportMissing") < 0);
+
+        for (int i = 0; i < 50; i++) {
+            config->setValue("exportBulk", "key" + String(i), "value-" + String(i));
+        }
+        capturePrint all;
+        const size_t total = config->exportJson(all);
+        assertTrue("Whole config streamed", total > 1000 && all.text.indexOf("\"key49\":\"value-49\"") >= 0 &&
+                   all.text.startsWith("{") && all.text.endsWith("}"));
+        assertTrue("Chunks bounded by buffer", all.largest <= CONFIG_EXPORT_BUFFER_SIZE && all.calls >= total / CONFIG_EXPORT_BUFFER_SIZE);
+
+        capturePrint closed;
+        closed.limit = 100;
+        assertEqual("Short sink stops export", static_cast<int>(config->exportJson(closed)), 100);
+        assertTrue("No writes after sink stops", closed.calls <= 100 / CONFIG_EXPORT_BUFFER_SIZE + 1);
+        Serial.printf("Exported %u bytes in %u writes of at most %u bytes\n", static_cast<unsigned int>(total),
+                      static_cast<unsigned int>(all.calls), static_cast<unsigned int>(all.largest));
+
+        Serial.println("Streaming export tests completed.\n");
+    }
+
     // Helper methods
     static void printMap(const std::map<String, std::map<String, String>>& config) {
         Serial.println("--- Config Map ---");
@@ -504,3 +794,5 @@ public:
 int testLib::_passCount = 0;
 int testLib::_failCount = 0;
 int testLib::_testCount = 0;
+int testLib::_asyncCallbacks = 0;
+int testLib::_asyncSucceeded = 0;
@@ -0,0 +1,490 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2025 Peter K Green (pkg40)
+ * Email: pkg40@yahoo.com
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Flash Wear Counter Test Suite
+ * Runs flashWearCounter against an in-memory byte store on the host:
+ * persistence across instances, ring-buffer recovery, deferred commits,
+ * corruption fuzzing and update throughput
+ */
+
+#pragma once
+#include <Arduino.h>
+#include <flashWearCounter.hpp>
+#ifdef CONFIGMGR_NATIVE
+#include <compat/ramByteStore.hpp>
+#endif
+
+class wearCounterTestSuite {
+private:
+    static int _testsPassed;
+    static int _testsFailed;
+    static int _totalTests;
+
+public:
+    static void runWearCounterTests() {
+        Serial.println("\n=== FLASH WEAR COUNTER TEST SUITE ===");
+
+        _testsPassed = 0;
+        _testsFailed = 0;
+        _totalTests = 0;
+
+#ifdef CONFIGMGR_NATIVE
+        testPersistenceAcrossBoots();
+        testRingRecovery();
+        testLegacyMigration();
+        testCrcProtection();
+        testBootCommit();
+        testByteAccounting();
+        testWearForecast();
+        testDeferredCommits();
+        testCorruptionFuzz();
+        testUpdateThroughput();
+        testTelemetry();
+#else
+        Serial.println("--- Skipping byte store tests (native only) ---");
+#endif
+
+        Serial.println("\n=== WEAR COUNTER TEST RESULTS ===");
+        Serial.printf("Total Tests: %d\n", _totalTests);
+        Serial.printf("Passed: %d\n", _testsPassed);
+        Serial.printf("Failed: %d\n", _testsFailed);
+        Serial.println("=================================\n");
+    }
+
+private:
+    static void testAssert(const String& testName, bool condition, const String& message = "") {
+        _totalTests++;
+        if (condition) {
+            Serial.printf("[PASS] %s\n", testName.c_str());
+            _testsPassed++;
+        } else {
+            Serial.printf("[FAIL] %s", testName.c_str());
+            if (message.length() > 0) {
+                Serial.printf(" - %s", message.c_str());
+            }
+            Serial.println();
+            _testsFailed++;
+        }
+    }
+
+#ifdef CONFIGMGR_NATIVE
+    static void testPersistenceAcrossBoots() {
+        Serial.println("--- Testing Persistence Across Boots ---");
+
+        ramByteStore store;
+        {
+            flashWearCounter counter(&store);
+            testAssert("First boot init", counter.begin());
+            testAssert("First boot count", counter.getBootCount() == 1);
+            testAssert("Fresh write count", counter.getWriteCount() == 0);
+            for (int i = 0; i < 5; i++) {
+                counter.update();
+            }
+        }
+
+        flashWearCounter rebooted(&store);
+        rebooted.begin();
+        testAssert("Boot count persisted", rebooted.getBootCount() == 2);
+        testAssert("Write count persisted", rebooted.getWriteCount() == 5);
+
+        Serial.println("Persistence tests completed.\n");
+    }
+
+    static void testRingRecovery() {
+        Serial.println("--- Testing Ring-Buffer Recovery ---");
+
+        ramByteStore store;
+        const uint32_t updates = 70000; // Wraps the 16-bit sequence
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            for (uint32_t i = 0; i < updates; i++) {
+                counter.update();
+            }
+        }
+
+        // Every wear slot is in use after a few laps
+        const uint16_t wearRecordSize = FLASH_WEAR_LOG_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE;
+        const uint16_t wearSlots = (DEFAULT_FLASH_WEAR_LOG_LENGTH - DEFAULT_BOOT_COUNTER_LOG_SLOTS * FLASH_WEAR_RECORD_SIZE) / wearRecordSize;
+        uint16_t used = 0;
+        for (uint16_t slot = 0; slot < wearSlots; slot++) {
+            const uint8_t* record = store.data() + DEFAULT_FLASH_WEAR_LOG_ADDRESS + slot * wearRecordSize;
+            if (record[wearRecordSize - 2] == FLASH_WEAR_LOG_VALID) {
+                used++;
+            }
+        }
+        testAssert("Writes spread over every slot", used == wearSlots, String(static_cast<unsigned>(used)));
+
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            testAssert("Count survives sequence wrap", counter.getWriteCount() == updates,
+                       String(static_cast<unsigned long>(counter.getWriteCount())));
+        }
+
+        // Tear the newest record: the previous one becomes current
+        const uint16_t newest = static_cast<uint16_t>((updates) % wearSlots); // slot 0 holds the seed record
+        store.data()[DEFAULT_FLASH_WEAR_LOG_ADDRESS + newest * wearRecordSize] ^= 0x01;
+        flashWearCounter torn(&store);
+        torn.begin();
+        testAssert("Torn record falls back to previous", torn.getWriteCount() == updates - 1,
+                   String(static_cast<unsigned long>(torn.getWriteCount())));
+
+        Serial.println("Ring-buffer recovery tests completed.\n");
+    }
+
+    static void testLegacyMigration() {
+        Serial.println("--- Testing Legacy Record Migration ---");
+
+        ramByteStore store;
+        store.begin(FLASH_WEAR_EEPROM_SIZE);
+        FlashWearRecord legacy{};
+        legacy.value = 1234;
+        legacy.valid = FLASH_WEAR_VALID;
+        memcpy(store.data() + DEFAULT_FLASH_WEAR_COUNTER_ADDRESS, &legacy, sizeof(legacy));
+        legacy.value = 42;
+        memcpy(store.data() + DEFAULT_BOOT_COUNTER_ADDRESS, &legacy, sizeof(legacy));
+
+        flashWearCounter counter(&store);
+        counter.begin();
+        testAssert("Legacy write count migrated", counter.getWriteCount() == 1234);
+        testAssert("Legacy boot count migrated", counter.getBootCount() == 43);
+
+        Serial.println("Legacy migration tests completed.\n");
+    }
+
+    static void testCrcProtection() {
+        Serial.println("--- Testing CRC-Protected Records ---");
+
+        const uint16_t wearRecordSize = FLASH_WEAR_LOG_VALUES * 4 + FLASH_WEAR_LOG_TRAILER_SIZE;
+        ramByteStore store;
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            for (int i = 0; i < 5; i++) {
+                counter.update();
+            }
+        }
+
+        // Two flips a rotate-XOR checksum cannot see (bit 0 of byte 0, bit 1 of byte 1)
+        uint8_t* newest = store.data() + DEFAULT_FLASH_WEAR_LOG_ADDRESS + 5 * wearRecordSize;
+        newest[0] ^= 0x01;
+        newest[1] ^= 0x02;
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            testAssert("Double bit flip detected", counter.getWriteCount() == 4,
+                       String(static_cast<unsigned long>(counter.getWriteCount())));
+        }
+
+        // A legacy record without its marker is not "recovered"
+        ramByteStore garbage;
+        garbage.begin(FLASH_WEAR_EEPROM_SIZE);
+        FlashWearRecord legacy{};
+        legacy.value = 5000;
+        legacy.valid = 0x12;
+        memcpy(garbage.data() + DEFAULT_FLASH_WEAR_COUNTER_ADDRESS, &legacy, sizeof(legacy));
+        memcpy(garbage.data() + DEFAULT_BOOT_COUNTER_ADDRESS, &legacy, sizeof(legacy));
+        flashWearCounter counter(&garbage);
+        counter.begin();
+        testAssert("Unmarked legacy counts ignored", counter.getWriteCount() == 0 && counter.getBootCount() == 1);
+
+        Serial.println("CRC-protected record tests completed.\n");
+    }
+
+    static void testBootCommit() {
+        Serial.println("--- Testing Boot-Time Commit ---");
+
+        ramByteStore store;
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            testAssert("First boot: one commit", store.getCommitCount() == 1,
+                       String(static_cast<unsigned long>(store.getCommitCount())));
+            const flashWearBootTiming& timing = counter.getBootTiming();
+            testAssert("Boot timing recorded", timing.commits == 1 && timing.totalMicros >= timing.commitMicros);
+        }
+
+        store.resetStats();
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            testAssert("Later boot: one commit", store.getCommitCount() == 1 && counter.getBootCount() == 2);
+        }
+
+        store.resetStats();
+        flashWearCounter counter(&store);
+        counter.setBootCommitDeferred(true);
+        counter.begin();
+        testAssert("Deferred boot: no commit", store.getCommitCount() == 0 && counter.isBootCommitPending() &&
+                   counter.getBootTiming().commits == 0);
+        counter.service();
+        testAssert("Idle service commits once", store.getCommitCount() == 1 && !counter.isBootCommitPending());
+        counter.service();
+        testAssert("Nothing left to commit", store.getCommitCount() == 1);
+
+        Serial.println("Boot-time commit tests completed.\n");
+    }
+
+    static void testByteAccounting() {
+        Serial.println("--- Testing Byte and Sector Accounting ---");
+
+        ramByteStore store;
+        {
+            flashWearCounter counter(&store);
+            counter.begin();
+            counter.update(100, 4096);
+            counter.update(5000, 4096);
+            counter.update();
+            testAssert("Bytes accumulated", counter.getBytesWritten() == 5100);
+            testAssert("Sectors estimated per block", counter.getSectorsErased() == 4,
+                       String(static_cast<unsigned long>(counter.getSectorsErased())));
+        }
+
+        flashWearCounter counter(&store);
+        counter.begin();
+        testAssert("Accounting persisted", counter.getBytesWritten() == 5100 && counter.getSectorsErased() == 4);
+
+        counter.setEraseCycleLimit(100, 10);
+        testAssert("Erase cycles per block", counter.getEraseCyclesPerBlock() > 0.39f && counter.getEraseCyclesPerBlock() < 0.41f);
+        testAssert("Percentage from erase cycles", counter.getWearPercentage() > 0.39f && counter.getWearPercentage() < 0.41f,
+                   String(counter.getWearPercentage(), 3));
+        counter.setEraseCycleLimit(0, 0);
+        testAssert("Write limit restored", counter.getWearPercentage() < 0.001f);
+
+        Serial.println("Byte and sector accounting tests completed.\n");
+    }
+
+    static void testWearForecast() {
+        Serial.println("--- Testing Wear-Rate Forecast ---");
+
+        ramByteStore store;
+        float persistedRate = 0.0f;
+        {
+            flashWearCounter counter(&store);
+            counter.begin(100000);
+            counter.setRateSmoothing(0.5f, 50);
+            testAssert("No forecast before a sample", counter.getForecast().hoursToRetirement == FLASH_WEAR_FORECAST_UNKNOWN);
+
+            for (int i = 0; i < 20; i++) {
+                counter.update();
+            }
+            delay(60);
+            counter.service();
+            const float firstRate = counter.getWriteRatePerHour();
+            testAssert("First sample sets the rate", firstRate > 100000.0f, String(firstRate, 0));
+
+            // A quiet interval halves it (alpha 0.5)
+            delay(55);
+            counter.service();
+            const float quietRate = counter.getWriteRatePerHour();
+            testAssert("Quiet interval decays the rate", quietRate < firstRate * 0.6f && quietRate > firstRate * 0.2f,
+                       String(quietRate, 0));
+
+            const flashWearForecast forecast = counter.getForecast();
+            const float expected = (100.0f - counter.getWearPercentage()) / (100.0f / 100000) / quietRate;
+            testAssert("Retirement projected from rate",
+                       forecast.hoursToRetirement > expected * 0.99f && forecast.hoursToRetirement < expected * 1.01f,
+                       String(forecast.hoursToRetirement, 3));
+            testAssert("Thresholds ordered", forecast.hoursToCaution < forecast.hoursToCritical &&
+                       forecast.hoursToCritical < forecast.hoursToRetirement);
+            testAssert("Writes per boot", forecast.writesPerBoot > 19.0f && forecast.writesPerBoot < 21.0f);
+
+            counter.update(); // Commits the average
+            persistedRate = counter.getWriteRatePerHour();
+        }
+
+        flashWearCounter counter(&store);
+        counter.begin(100000);
+        testAssert("Rate carried across boots", counter.getWriteRatePerHour() == persistedRate);
+        testAssert("Crossed threshold projects zero", counter.getHoursToWear(0.01f) == 0.0f);
+
+        Serial.println("Wear-rate forecast tests completed.\n");
+    }
+
+    static void testDeferredCommits() {
+        Serial.println("--- Testing Deferred Commits ---");
+
+        ramByteStore store;
+        flashWearCounter counter(&store);
+        counter.begin();
+        counter.setCommitPolicy(16);
+        store.resetStats();
+
+        for (int i = 0; i < 100; i++) {
+            counter.update();
+        }
+        testAssert("Commits batched", counter.getCommitCount() == 6 && store.getCommitCount() == 6,
+                   String(static_cast<unsigned long>(store.getCommitCount())));
+        testAssert("Commits avoided counted", counter.getCommitsAvoided() == 90);
+        testAssert("Remainder pending", counter.getPendingIncrements() == 4);
+
+        // Simulated power loss: a second instance reads what reached the store
+        {
+            flashWearCounter afterPowerLoss(&store);
+            afterPowerLoss.begin();
+            testAssert("Under-count bounded by batch size", counter.getWriteCount() - afterPowerLoss.getWriteCount() < 16);
+        }
+
+        testAssert("Flush commits remainder", counter.flush() && counter.getPendingIncrements() == 0);
+        counter.setCommitPolicy(1000, 1);
+        counter.update();
+        delay(3);
+        testAssert("Service commits after window", counter.service() && counter.getPendingIncrements() == 0);
+
+        Serial.println("Deferred commit tests completed.\n");
+    }
+
+    static void testCorruptionFuzz() {
+        Serial.println("--- Fuzzing Log Corruption ---");
+
+        ramByteStore reference;
+        {
+            flashWearCounter counter(&reference);
+            counter.begin();
+            for (int i = 0; i < 500; i++) {
+                counter.update();
+            }
+        }
+        const uint32_t trueCount = 500;
+
+        uint32_t seed = 12345;
+        int overReports = 0;
+        int failedInits = 0;
+        for (int iteration = 0; iteration < 2000; iteration++) {
+            ramByteStore store;
+            store.begin(FLASH_WEAR_EEPROM_SIZE);
+            memcpy(store.data(), reference.data(), FLASH_WEAR_EEPROM_SIZE);
+            for (int flips = 0; flips < 4; flips++) {
+                seed = seed * 1103515245u + 12345u;
+                const uint16_t offset = DEFAULT_FLASH_WEAR_LOG_ADDRESS + (seed >> 8) % DEFAULT_FLASH_WEAR_LOG_LENGTH;
+                store.data()[offset] = static_cast<uint8_t>(seed >> 24);
+            }
+            flashWearCounter counter(&store);
+            if (!counter.begin()) {
+                failedInits++;
+            }
+            if (counter.getWriteCount() > trueCount) {
+                overReports++;
+            }
+        }
+        testAssert("Corrupted logs always initialize", failedInits == 0);
+        testAssert("Corruption never over-reports", overReports == 0, String(overReports));
+
+        Serial.println("Corruption fuzzing completed.\n");
+    }
+
+    static void testUpdateThroughput() {
+        Serial.println("--- Measuring Update Throughput ---");
+
+        ramByteStore store;
+        flashWearCounter counter(&store);
+        counter.begin();
+        counter.setCommitPolicy(1000);
+
+        const uint32_t updates = 200000;
+        unsigned long start = micros();
+        for (uint32_t i = 0; i < updates; i++) {
+            counter.update();
+        }
+        unsigned long elapsed = micros() - start;
+
+        Serial.printf("%lu updates in %lu us (%.0f updates/s), %llu store commits\n",
+                      static_cast<unsigned long>(updates), elapsed,
+                      elapsed ? updates * 1e6 / elapsed : 0.0,
+                      static_cast<unsigned long long>(store.getCommitCount()));
+        testAssert("Every increment counted", counter.getWriteCount() == updates);
+
+        Serial.println("Update throughput measurement completed.\n");
+    }
+
+    static void testTelemetry() {
+        Serial.println("--- Testing Telemetry Snapshot ---");
+
+        ramByteStore store;
+        flashWearCounter counter(&store);
+        counter.begin(1000);
+        for (int i = 0; i < 10; i++) {
+            counter.update(2000, 4096);
+        }
+
+        flashWearTelemetry telemetry;
+        counter.getTelemetry(&telemetry);
+        testAssert("Snapshot counts", telemetry.writeCount == 10 && telemetry.maxWrites == 1000 &&
+                   telemetry.bytesWritten == 20000 && telemetry.sectorsErased == 10 && telemetry.bootCount == 1);
+        testAssert("Snapshot percentage", telemetry.wearCentiPercent == 100, String(static_cast<unsigned>(telemetry.wearCentiPercent)));
+        testAssert("Snapshot flags", telemetry.flags == FLASH_WEAR_TELEMETRY_INITIALIZED && telemetry.warningLevel == 0);
+
+        const int rounds = 20000;
+        unsigned long start = micros();
+        for (int i = 0; i < rounds; i++) {
+            counter.getTelemetry(&telemetry);
+        }
+        const unsigned long snapshotMicros = micros() - start;
+        start = micros();
+        size_t length = 0;
+        for (int i = 0; i < rounds; i++) {
+            length += counter.getStatusString().length();
+        }
+        const unsigned long stringMicros = micros() - start;
+        Serial.printf("%d snapshots: %lu us, %d status strings: %lu us (%lu chars)\n",
+                      rounds, snapshotMicros, rounds, stringMicros, static_cast<unsigned long>(length));
+        // Timings are printed, not compared: reading must simply not disturb the counter
+        testAssert("Repeated snapshots unchanged", telemetry.writeCount == 10 && telemetry.bytesWritten == 20000 &&
+                   telemetry.wearCentiPercent == 100);
+        testAssert("Repeated status strings identical",
+                   length == static_cast<size_t>(rounds) * counter.getStatusString().length(), String(static_cast<unsigned long>(length)));
+
+        // Update cost with and without per-write logging
+        const int updates = 2000;
+        counter.setVerboseLogging(true);
+        start = micros();
+        for (int i = 0; i < updates; i++) {
+            counter.update();
+        }
+        const unsigned long verboseMicros = micros() - start;
+        counter.setVerboseLogging(false);
+        start = micros();
+        for (int i = 0; i < updates; i++) {
+            counter.update();
+        }
+        const unsigned long quietMicros = micros() - start;
+        Serial.printf("%d updates: %lu us verbose, %lu us quiet\n", updates, verboseMicros, quietMicros);
+
+        // Crossing into caution is logged once, then silence
+        counter.setWarningThresholds(0.0f, 1000.0f, 2000.0f);
+        counter.update();
+        counter.getTelemetry(&telemetry);
+        testAssert("Caution reported in snapshot", telemetry.warningLevel == 1);
+
+        Serial.println("Telemetry snapshot tests completed.\n");
+    }
+#endif
+};
+
+// Static member definitions
+int wearCounterTestSuite::_testsPassed = 0;
+int wearCounterTestSuite::_testsFailed = 0;
+int wearCounterTestSuite::_totalTests = 0;